@@ -4,15 +4,16 @@ cd ~/Desktop/wayfire-launcher/files
 echo "Building futuristic-launcher with GTK3..."
 echo "(This avoids GTK2/3/4 mixing issues)"
 echo ""
-g++ -std=c++17 -Wall -O2 futuristic-launcher.cpp -o futuristic-launcher \
+g++ -std=c++17 -Wall -O2 -pthread client.cpp core/*.cpp -o futuristic-launcher &&
+g++ -std=c++17 -Wall -O2 -pthread futuristic-launcher.cpp core/*.cpp -o futuristic-launcher-daemon \
     $(pkg-config --cflags --libs gtk+-3.0 gtk-layer-shell-0 epoxy)
 if [ $? -eq 0 ]; then
     echo ""
     echo "✓ Build successful!"
     echo ""
     echo "Installing..."
-    sudo cp futuristic-launcher /usr/local/bin/
-    sudo chmod +x /usr/local/bin/futuristic-launcher
+    sudo cp futuristic-launcher futuristic-launcher-daemon /usr/local/bin/
+    sudo chmod +x /usr/local/bin/futuristic-launcher /usr/local/bin/futuristic-launcher-daemon
     echo "✓ Installed to /usr/local/bin/futuristic-launcher"
     echo ""
     echo "═══════════════════════════════════════════════"
@@ -0,0 +1,102 @@
+#!/bin/bash
+# Control socket check: starts each launcher build as a daemon on a private
+# XDG_RUNTIME_DIR, sends every control command and requires an "ok" reply,
+# then reports --ping round-trip latency. Exits non-zero on any failure.
+#
+# Usage: bench/control-check.sh [--backend weston|xvfb] [--pings N] BINARY...
+
+set -euo pipefail
+
+BACKEND=""
+PINGS=1000
+BINARIES=()
+
+usage() {
+    echo "Usage: $0 [--backend weston|xvfb] [--pings N] BINARY..."
+    echo "  --backend   Headless Weston (default when installed) or Xvfb"
+    echo "  --pings     Round trips for the latency figures (default 1000)"
+}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --backend) BACKEND=$2; shift 2 ;;
+        --pings) PINGS=$2; shift 2 ;;
+        -h|--help) usage; exit 0 ;;
+        -*) usage >&2; exit 2 ;;
+        *) BINARIES+=("$(realpath "$1")"); shift ;;
+    esac
+done
+
+if [ ${#BINARIES[@]} -eq 0 ]; then
+    usage >&2
+    exit 2
+fi
+
+source "$(dirname "$0")/headless.sh"
+
+# No prefetch or metrics file I/O while measuring
+cat > "$CONFIG" <<EOF
+prefetch_apps=0
+metrics_interval_s=0
+EOF
+
+# One connection, one command per line, as the client sends them; prints
+# "command reply" per command and fails unless every reply is "ok"
+check_commands() {
+    python3 - "$XDG_RUNTIME_DIR/futuristic-launcher.sock" <<'PY'
+import socket, sys
+
+commands = ["toggle", "toggle", "show", "hide", "query firefox", "calc 2*21",
+            "command true", "hide", "stats", "metrics", "ping"]
+sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+sock.settimeout(5)
+sock.connect(sys.argv[1])
+stream = sock.makefile("rw")
+failed = 0
+for command in commands:
+    stream.write(command + "\n")
+    stream.flush()
+    body = 0
+    while True:
+        line = stream.readline()
+        if not line:
+            status = "error connection closed"
+            break
+        status = line.rstrip("\n")
+        if status == "ok" or status.startswith("error"):
+            break
+        body += 1
+    print("  %-16s %s%s" % (command, status, " (%d lines)" % body if body else ""))
+    if status != "ok":
+        failed += 1
+sys.exit(1 if failed else 0)
+PY
+}
+
+start_compositor
+failures=0
+for binary in "${BINARIES[@]}"; do
+    echo "$(basename "$binary") ($BACKEND)"
+    start_daemon "$binary"
+
+    if ! check_commands; then
+        echo "  FAIL: not every command was answered with ok" >&2
+        failures=$((failures + 1))
+    fi
+
+    # "N round trips: min ... p50 ... p99 ... max ... ms"
+    pings=$("$binary" --ping "$PINGS" || true)
+    echo "  $pings"
+    if [ "${pings%% *}" != "$PINGS" ]; then
+        echo "  FAIL: expected $PINGS round trips" >&2
+        failures=$((failures + 1))
+    fi
+
+    if ! stop_daemon; then
+        echo "  FAIL: daemon did not exit cleanly on SIGTERM; log follows" >&2
+        cat "$WORK/daemon.log" >&2
+        failures=$((failures + 1))
+    fi
+done
+
+exit $((failures > 0))
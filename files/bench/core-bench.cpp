@@ -0,0 +1,705 @@
+/*
+ * Microbenchmarks for the launcher core (no GTK needed)
+ *
+ * Synthetic catalogs of 100 to 1M entries plus real .desktop directories.
+ * Results go to stdout as JSON lines, one object per measurement; a summary
+ * goes to stderr. --smoke runs small sizes and checks basic invariants.
+ *
+ * MIT License
+ */
+
+#include "../core/config.h"
+#include "../core/desktop.h"
+#include "../core/usage.h"
+#include "../core/catalog.h"
+#include "../core/search.h"
+#include "../core/metrics.h"
+#include "../core/dmenu.h"
+#include "../core/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_us(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Options {
+    bool smoke = false;
+    size_t max_entries = 1000000;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> corpora;
+    std::string out_path;
+};
+
+std::ostream *results = &std::cout;
+int failures = 0;
+
+// One JSON object per line; values are numbers unless quoted by the caller
+class Result {
+    std::ostringstream fields;
+
+public:
+    explicit Result(const std::string& bench) {
+        fields << "{\"bench\":\"" << bench << "\"";
+    }
+
+    Result& text(const char *key, const std::string& value) {
+        fields << ",\"" << key << "\":\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') fields << '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) fields << c;
+        }
+        fields << "\"";
+        return *this;
+    }
+
+    // Counts and byte sizes are printed exactly, timings to six digits
+    Result& number(const char *key, double value) {
+        fields << ",\"" << key << "\":";
+        if (value == std::floor(value) && std::fabs(value) < 1e15) {
+            fields << static_cast<int64_t>(value);
+        } else {
+            fields << std::setprecision(6) << value;
+        }
+        return *this;
+    }
+
+    ~Result() {
+        *results << fields.str() << "}\n";
+    }
+};
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        failures++;
+    }
+}
+
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    return samples[std::min(samples.size() - 1, index == 0 ? 0 : index - 1)];
+}
+
+// Deterministic app names built from syllables, with a few real-looking ones mixed in
+std::vector<DesktopApp> synthetic_apps(size_t count) {
+    static const char *syllables[] = {
+        "fi", "re", "fox", "ter", "mi", "nal", "co", "de", "ed", "it", "or", "ga", "me",
+        "vi", "de", "o", "pla", "yer", "ma", "il", "pho", "to", "sy", "nc", "ka", "te"
+    };
+    static const char *words[] = {
+        "browser", "terminal", "editor", "viewer", "manager", "player", "client",
+        "settings", "monitor", "tool", "office", "image", "network", "music", "game"
+    };
+    static const char *real[] = {"Firefox", "Terminal", "Code Editor", "Files", "Settings"};
+
+    std::mt19937 rng(42);
+    auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+
+    std::vector<DesktopApp> apps;
+    apps.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        DesktopApp app;
+        if (i < sizeof(real) / sizeof(real[0])) {
+            app.name = real[i];
+        } else {
+            size_t length = 2 + pick(3);
+            for (size_t s = 0; s < length; s++) app.name += syllables[pick(26)];
+            app.name[0] = static_cast<char>(toupper(app.name[0]));
+            if (pick(3) == 0) {
+                app.name += " ";
+                app.name += words[pick(15)];
+            }
+        }
+        app.comment = std::string(words[pick(15)]) + " " + words[pick(15)] + " for the desktop";
+        app.id = "org.synthetic.App" + std::to_string(i) + ".desktop";
+        app.path = "/usr/share/applications/" + app.id;
+        app.exec = "app-" + std::to_string(i) + " --new-window %U";
+        app.icon = "app-" + std::to_string(i % 500);
+        app.categories = pick(2) ? "Utility;" : "Network;WebBrowser;";
+        apps.push_back(std::move(app));
+    }
+    return apps;
+}
+
+struct Loaded {
+    AppCatalog catalog;
+    AppIndex index;
+};
+
+void build_catalog(std::vector<DesktopApp>& apps, Loaded& loaded, const std::string& dataset) {
+    auto start = Clock::now();
+    size_t parsed = 0;
+    for (auto& app : apps) {
+        if (app.argv.empty() && DesktopExec::parse(app, app.argv)) parsed++;
+    }
+    double parse_us = elapsed_us(start);
+
+    start = Clock::now();
+    loaded.catalog.reserve(apps.size());
+    for (const auto& app : apps) {
+        loaded.catalog.add(app);
+    }
+    loaded.catalog.shrink_to_fit();
+    loaded.index.build(loaded.catalog);
+    double build_us = elapsed_us(start);
+
+    if (parsed > 0) {
+        Result("exec_parse").text("dataset", dataset).number("entries", parsed)
+            .number("ns_per_entry", 1000.0 * parse_us / parsed);
+    }
+    Result("catalog_build").text("dataset", dataset).number("entries", apps.size())
+        .number("total_us", build_us).number("ns_per_entry", apps.empty() ? 0.0 : 1000.0 * build_us / apps.size())
+        .number("catalog_bytes", loaded.catalog.memory_bytes());
+
+    // Every slot must be reachable through its ID
+    size_t lookups = std::min<size_t>(apps.size(), 200000);
+    size_t found = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        size_t slot = (i * 7919) % apps.size();
+        found += loaded.index.find(loaded.catalog.id(slot)) == static_cast<int>(slot);
+    }
+    double find_us = elapsed_us(start);
+    check(found == lookups, dataset + ": index lookups");
+    Result("index_find").text("dataset", dataset).number("entries", apps.size())
+        .number("ns_per_op", lookups ? 1000.0 * find_us / lookups : 0.0);
+}
+
+void bench_rank(const Loaded& loaded, const UsageJournal& usage, const std::string& dataset, bool smoke) {
+    static const char *queries[] = {"f", "fi", "fir", "firefox", "term", "code ed", "xq"};
+    std::vector<uint32_t> out;
+
+    for (const char *query : queries) {
+        // Each query runs until ~0.2 s (smoke: a few calls) have been spent on it
+        std::vector<double> samples;
+        double budget_us = smoke ? 2000.0 : 200000.0;
+        double spent_us = 0.0;
+        while (samples.size() < 3 || (spent_us < budget_us && samples.size() < 10000)) {
+            auto start = Clock::now();
+            rank_apps(loaded.catalog, loaded.index, usage, query, out);
+            double us = elapsed_us(start);
+            samples.push_back(us);
+            spent_us += us;
+        }
+
+        double mean = spent_us / samples.size();
+        Result("rank").text("dataset", dataset).text("query", query)
+            .number("entries", loaded.catalog.size()).number("iterations", samples.size())
+            .number("matches", out.size()).number("mean_us", mean)
+            .number("p50_us", percentile(samples, 50)).number("p95_us", percentile(samples, 95))
+            .number("ns_per_entry", loaded.catalog.empty() ? 0.0 : 1000.0 * mean / loaded.catalog.size());
+        std::cerr << "  rank " << std::setw(8) << dataset << " " << std::setw(8) << loaded.catalog.size()
+                  << " '" << query << "': " << std::fixed << std::setprecision(1) << percentile(samples, 50)
+                  << " us p50, " << out.size() << " matches" << std::defaultfloat << std::endl;
+    }
+}
+
+// A name typed in full must land near the top. Comment matches and usage
+// bonuses can legitimately put other apps ahead of it.
+void check_exact_names(const Loaded& loaded, const UsageJournal& usage, const std::string& dataset) {
+    std::vector<uint32_t> out;
+    for (uint32_t slot = 0; slot < std::min<size_t>(loaded.catalog.size(), 20); slot++) {
+        std::string name(loaded.catalog.name(slot));
+        rank_apps(loaded.catalog, loaded.index, usage, name, out);
+        size_t top = std::min<size_t>(out.size(), 10);
+        check(std::find(out.begin(), out.begin() + top, slot) != out.begin() + top,
+              dataset + ": " + name + " in the top 10 for its own name");
+    }
+}
+
+void bench_synthetic(const Options& options, const std::string& tmp_dir) {
+    Config config;
+    UsageJournal usage;
+    usage.load(tmp_dir + "/usage-synthetic", config);
+    for (int i = 0; i < 200; i++) {
+        usage.record("org.synthetic.App" + std::to_string(i % 40) + ".desktop", i % 2 ? "fi" : "term");
+    }
+
+    for (size_t entries = 100; entries <= options.max_entries; entries *= 10) {
+        std::vector<DesktopApp> apps = synthetic_apps(entries);
+        Loaded loaded;
+        build_catalog(apps, loaded, "synthetic");
+        for (uint32_t slot = 0; slot < loaded.catalog.size(); slot++) {
+            if (const UsageJournal::AppUsage *stats = usage.usage(std::string(loaded.catalog.id(slot)))) {
+                loaded.catalog.frecency[slot] = stats->frecency;
+            }
+        }
+        bench_rank(loaded, usage, "synthetic", options.smoke);
+        // Larger catalogs have more than ten comments mentioning each name
+        if (entries <= 10000) {
+            check_exact_names(loaded, usage, "synthetic");
+        }
+    }
+}
+
+void bench_corpus(const std::string& dir, bool smoke) {
+    auto start = Clock::now();
+    std::vector<DesktopApp> apps = scan_desktop_files({dir});
+    double scan_us = elapsed_us(start);
+
+    Result("desktop_scan").text("dataset", dir).number("entries", apps.size())
+        .number("total_us", scan_us).number("us_per_file", apps.empty() ? 0.0 : scan_us / apps.size());
+    std::cerr << "  scan " << dir << ": " << apps.size() << " apps in "
+              << std::fixed << std::setprecision(1) << scan_us / 1000.0 << " ms" << std::defaultfloat << std::endl;
+    if (apps.empty()) return;
+
+    UsageJournal usage;
+    Loaded loaded;
+    build_catalog(apps, loaded, dir);
+    bench_rank(loaded, usage, dir, smoke);
+    check_exact_names(loaded, usage, dir);
+}
+
+void bench_config(const std::string& tmp_dir) {
+    Config config;
+    for (int i = 0; i < 500; i++) {
+        config.favorites.insert("org.synthetic.App" + std::to_string(i) + ".desktop");
+    }
+    std::string path = tmp_dir + "/futuristic-launcher.conf";
+
+    auto start = Clock::now();
+    std::string contents = config.serialize();
+    double serialize_us = elapsed_us(start);
+
+    start = Clock::now();
+    bool written = Config::write_file_atomic(path, contents);
+    double write_us = elapsed_us(start);
+    check(written, "config: write_file_atomic");
+
+    Config loaded;
+    start = Clock::now();
+    loaded.load_from(path);
+    double load_us = elapsed_us(start);
+    check(loaded.favorites == config.favorites, "config: favorites survive a round trip");
+
+    Result("config").number("favorites", config.favorites.size()).number("serialize_us", serialize_us)
+        .number("write_atomic_us", write_us).number("load_us", load_us);
+}
+
+void bench_usage(const std::string& tmp_dir, bool smoke) {
+    std::string dir = tmp_dir + "/usage";
+    Config config;
+    int records = smoke ? 300 : 5000;
+
+    UsageJournal journal;
+    journal.load(dir, config);
+    auto start = Clock::now();
+    for (int i = 0; i < records; i++) {
+        journal.record("org.synthetic.App" + std::to_string(i % 97) + ".desktop", i % 3 ? "fire" : "te");
+    }
+    double record_us = elapsed_us(start);
+
+    start = Clock::now();
+    journal.compact();
+    double compact_us = elapsed_us(start);
+    for (int i = 0; i < 100; i++) {
+        journal.record("org.synthetic.App" + std::to_string(i) + ".desktop", "x");
+    }
+
+    // Launches between serializing and writing a snapshot move to the new journal
+    std::string snapshot = journal.begin_compaction();
+    check(!journal.needs_compaction(), "usage: one compaction in flight at a time");
+    for (int i = 0; i < 10; i++) {
+        journal.record("org.synthetic.App1.desktop", "late");
+    }
+    journal.finish_compaction(Config::write_file_atomic(journal.snapshot_path(), snapshot));
+
+    UsageJournal reloaded;
+    start = Clock::now();
+    reloaded.load(dir, config);
+    double load_us = elapsed_us(start);
+
+    const UsageJournal::AppUsage *before = journal.usage("org.synthetic.App1.desktop");
+    const UsageJournal::AppUsage *after = reloaded.usage("org.synthetic.App1.desktop");
+    check(before && after && before->count == after->count, "usage: counts survive snapshot plus journal");
+
+    // Crash after the snapshot rename but before the swap: the next start
+    // skips the stale journal and must not keep appending under it
+    std::string crash_dir = tmp_dir + "/usage-crash";
+    {
+        UsageJournal crashed;
+        crashed.load(crash_dir, config);
+        for (int i = 0; i < 20; i++) {
+            crashed.record("org.synthetic.App" + std::to_string(i % 4) + ".desktop", "cr");
+        }
+        Config::write_file_atomic(crashed.snapshot_path(), crashed.begin_compaction());
+    }
+    UsageJournal restarted;
+    restarted.load(crash_dir, config);
+    for (int i = 0; i < 10; i++) {
+        restarted.record("org.synthetic.App1.desktop", "cr");
+    }
+    UsageJournal recovered;
+    recovered.load(crash_dir, config, true);
+    before = restarted.usage("org.synthetic.App1.desktop");
+    after = recovered.usage("org.synthetic.App1.desktop");
+    check(before && after && before->count == 15 && after->count == before->count,
+          "usage: launches after a stale journal survive a reload");
+
+    Result("usage").number("records", records).number("record_us", record_us / records)
+        .number("compact_us", compact_us).number("load_us", load_us);
+}
+
+void bench_calculator(bool smoke) {
+    if (system("command -v bc >/dev/null 2>&1") != 0) {
+        std::cerr << "  calculator: bc not installed, skipped" << std::endl;
+        return;
+    }
+    std::vector<double> samples;
+    double value = 0.0;
+    for (int i = 0; i < (smoke ? 3 : 20); i++) {
+        auto start = Clock::now();
+        value = calculate_expression("2 * 21");
+        samples.push_back(elapsed_us(start));
+    }
+    check(value == 42.0, "calculator: 2 * 21");
+    Result("calculator").number("iterations", samples.size())
+        .number("p50_us", percentile(samples, 50)).number("p95_us", percentile(samples, 95));
+}
+
+// Daemon metrics are updated from several threads; measures contended adds
+void bench_metrics(bool smoke) {
+    const int threads = 4;
+    const int adds = smoke ? 20000 : 1000000;
+    MetricCounter counter;
+    LatencyHistogram hist;
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&counter, &hist, adds, t] {
+            for (int i = 0; i < adds; i++) {
+                counter.add();
+                hist.add((i + t) % 5000);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double total_us = elapsed_us(start);
+
+    uint64_t expected = static_cast<uint64_t>(threads) * adds;
+    check(counter.get() == expected && hist.count() == expected, "metrics: no lost updates");
+    check(hist.percentile(50) >= 2048 && hist.percentile(50) <= 4096, "metrics: histogram p50 bucket");
+
+    PrometheusText text("test_");
+    text.counter("adds_total", "Adds", counter.get());
+    text.histogram("add_seconds", "Values", hist);
+    std::string body = text.str();
+    std::string count_line = "test_add_seconds_count " + std::to_string(expected) + "\n";
+    check(body.find("# TYPE test_adds_total counter\n") != std::string::npos &&
+          body.find("test_add_seconds_bucket{le=\"+Inf\"} " + std::to_string(expected)) != std::string::npos &&
+          body.find(count_line) != std::string::npos, "metrics: Prometheus text");
+
+    Result("metrics").number("threads", threads).number("adds", expected)
+        .number("add_ns", total_us * 1000.0 / adds);
+}
+
+// `find /`-like paths, newline-separated, as --dmenu would read them from a pipe
+std::string synthetic_paths(size_t count) {
+    static const char *dirs[] = {"usr", "share", "lib", "icons", "local", "home", "src", "doc", "firefox", "python3"};
+    static const char *exts[] = {".png", ".so", ".py", ".txt", ".desktop", ""};
+    std::mt19937 rng(7);
+    std::string out;
+    out.reserve(count * 48);
+    for (size_t i = 0; i < count; i++) {
+        size_t depth = 2 + rng() % 4;
+        for (size_t d = 0; d < depth; d++) {
+            out += '/';
+            out += dirs[rng() % 10];
+        }
+        out += "/file" + std::to_string(i) + exts[rng() % 6] + "\n";
+    }
+    return out;
+}
+
+// Brute-force reference for DmenuFilter: every line scored, best `limit` kept
+std::vector<uint32_t> dmenu_reference(const LineStore& store, const std::string& query, size_t limit) {
+    std::vector<std::pair<int, uint32_t>> hits;
+    for (uint32_t i = 0; i < store.size(); i++) {
+        int score = query.empty() ? 1 : fuzzy_score(store.line(i), query);
+        if (score > 0) hits.push_back({-score, i});
+    }
+    std::sort(hits.begin(), hits.end());
+    std::vector<uint32_t> out;
+    for (size_t i = 0; i < std::min(limit, hits.size()); i++) out.push_back(hits[i].second);
+    return out;
+}
+
+void check_dmenu() {
+    LineStore store;
+    std::string input = "alpha\nbe";
+    store.append(input.data(), input.size());
+    check(store.size() == 1, "dmenu: incomplete line is held back");
+    input = "ta\n\ngamma";
+    for (char c : input) store.append(&c, 1);
+    store.finish();
+    check(store.size() == 3 && store.line(1) == "beta" && store.line(2) == "gamma",
+          "dmenu: lines split across reads, empty lines skipped, last line without newline");
+
+    LineStore paths;
+    std::string text = synthetic_paths(20000);
+    for (size_t offset = 0; offset < text.size(); offset += 4093) {
+        paths.append(text.data() + offset, std::min<size_t>(4093, text.size() - offset));
+    }
+    paths.finish();
+    check(paths.size() == 20000 && paths.line(12345).find("/file12345") != std::string_view::npos,
+          "dmenu: lines survive chunk boundaries");
+
+    DmenuFilter filter(paths, 50);
+    std::vector<uint32_t> got;
+    filter.set_query("fire");
+    while (!filter.advance(3000)) {}
+    filter.results(got);
+    check(got == dmenu_reference(paths, "fire", 50), "dmenu: top results match a full sort");
+
+    filter.set_query("file1999");
+    while (!filter.advance(3000)) {}
+    filter.results(got);
+    check(got == dmenu_reference(paths, "file1999", 50), "dmenu: narrowed query");
+
+    filter.set_query("");
+    filter.advance(10);
+    filter.results(got);
+    check(got.size() == 10 && got[9] == 9, "dmenu: empty query lists input order");
+
+    // Items that arrive after the query was typed are still ranked
+    LineStore growing;
+    DmenuFilter live(growing, 5);
+    live.set_query("zz");
+    std::string first = "azz\nnope\n";
+    growing.append(first.data(), first.size());
+    live.advance(100);
+    std::string later = "zz top\n";
+    growing.append(later.data(), later.size());
+    live.advance(100);
+    live.results(got);
+    check(got.size() == 2 && got[0] == 2, "dmenu: late input is scored");
+
+    LineStore capped(2 * LineStore::CHUNK_BYTES);
+    std::string big = synthetic_paths(100000);
+    capped.append(big.data(), big.size());
+    capped.finish();
+    check(capped.dropped_lines() > 0 && capped.memory_bytes() <= 2 * LineStore::CHUNK_BYTES,
+          "dmenu: memory cap drops the overflow");
+
+    // Per-worker heaps merged must rank exactly like one thread, whole or in batches
+    ThreadPool pool(4);
+    LineStore many;
+    std::string many_text = synthetic_paths(100000);
+    many.append(many_text.data(), many_text.size());
+    many.finish();
+    DmenuFilter parallel(many, 120, &pool);
+    parallel.set_query("file99");
+    parallel.advance(many.size());
+    parallel.results(got);
+    check(got == dmenu_reference(many, "file99", 120), "dmenu: parallel scan matches a full sort");
+    parallel.set_query("fire");
+    while (!parallel.advance(DmenuFilter::PARALLEL_MIN_LINES + 1000)) {}
+    parallel.results(got);
+    check(got == dmenu_reference(many, "fire", 120), "dmenu: parallel batches match a full sort");
+}
+
+void check_thread_pool() {
+    ThreadPool pool(4);
+    const size_t count = 100003;
+    std::vector<std::atomic<int>> seen(count);
+    std::atomic<bool> bad_worker{false};
+    for (int round = 0; round < 20; round++) {
+        pool.parallel_for(count, 97, [&](size_t begin, size_t end, unsigned worker) {
+            if (worker >= pool.size()) bad_worker = true;
+            // Early chunks are slow, so the owners of later ones have to steal
+            if (begin < count / 8) std::this_thread::sleep_for(std::chrono::microseconds(50));
+            for (size_t i = begin; i < end; i++) seen[i].fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    bool exact = true;
+    for (const auto& n : seen) exact &= n.load() == 20;
+    check(exact && !bad_worker, "thread pool: every item runs once per parallel_for");
+
+    size_t calls = 0;
+    pool.parallel_for(10, 64, [&](size_t begin, size_t end, unsigned worker) { calls += end - begin; });
+    pool.parallel_for(0, 64, [&](size_t begin, size_t end, unsigned worker) { calls += 1000; });
+    check(calls == 10, "thread pool: a single chunk runs inline, nothing for no items");
+}
+
+// Ingest throughput and full-scan cost for large piped inputs
+void bench_dmenu(const Options& options) {
+    size_t count = options.smoke ? 100000 : std::max<size_t>(options.max_entries, 2000000);
+    std::string text = synthetic_paths(count);
+
+    LineStore store(size_t(4) << 30);
+    const size_t READ = 64 << 10;
+    auto start = Clock::now();
+    for (size_t offset = 0; offset < text.size(); offset += READ) {
+        store.append(text.data() + offset, std::min(READ, text.size() - offset));
+    }
+    store.finish();
+    double ingest_us = elapsed_us(start);
+
+    Result("dmenu_ingest").number("lines", store.size()).number("bytes", text.size())
+        .number("mb_per_s", text.size() / ingest_us).number("memory_bytes", store.memory_bytes());
+    std::cerr << "  dmenu ingest " << store.size() << " lines: " << std::fixed << std::setprecision(1)
+              << text.size() / ingest_us << " MB/s" << std::defaultfloat << std::endl;
+
+    for (const char *query : {"fi", "usrshare", "file99", "xq"}) {
+        DmenuFilter filter(store, 120);
+        std::vector<uint32_t> out;
+        start = Clock::now();
+        filter.set_query(query);
+        while (!filter.advance(65536)) {}
+        filter.results(out);
+        double scan_us = elapsed_us(start);
+        Result("dmenu_scan").number("lines", store.size()).text("query", query)
+            .number("scan_us", scan_us).number("ns_per_line", scan_us * 1000.0 / store.size())
+            .number("results", out.size());
+        std::cerr << "  dmenu scan " << store.size() << " '" << query << "': " << std::fixed << std::setprecision(1)
+                  << scan_us / 1000.0 << " ms" << std::defaultfloat << std::endl;
+    }
+
+    // Scaling from 1 to max_threads workers, one full scan per advance(); best of three
+    for (const char *query : {"fi", "file99"}) {
+        double single_us = 0;
+        for (unsigned threads = 1; threads <= options.max_threads; threads++) {
+            ThreadPool pool(threads);
+            double best_us = 0;
+            for (int run = 0; run < 3; run++) {
+                DmenuFilter filter(store, 120, &pool);
+                std::vector<uint32_t> out;
+                start = Clock::now();
+                filter.set_query(query);
+                filter.advance(store.size());
+                filter.results(out);
+                double scan_us = elapsed_us(start);
+                if (run == 0 || scan_us < best_us) best_us = scan_us;
+            }
+            if (threads == 1) single_us = best_us;
+            Result("dmenu_parallel").number("lines", store.size()).text("query", query)
+                .number("threads", threads).number("scan_us", best_us).number("speedup", single_us / best_us);
+            std::cerr << "  dmenu parallel " << store.size() << " '" << query << "' x" << threads << ": "
+                      << std::fixed << std::setprecision(1) << best_us / 1000.0 << " ms ("
+                      << single_us / best_us << "x)" << std::defaultfloat << std::endl;
+        }
+    }
+}
+
+void check_exec_parsing() {
+    DesktopApp app;
+    app.name = "Files";
+    app.icon = "folder";
+    app.exec = "\"/opt/My App/run\" --name=%c %i %U";
+    std::vector<std::string> argv;
+    check(DesktopExec::parse(app, argv) &&
+          argv == std::vector<std::string>({"/opt/My App/run", "--name=Files", "--icon", "folder"}),
+          "exec: quoting and field codes");
+    app.exec = "run foo%ibar";
+    check(DesktopExec::parse(app, argv) &&
+          argv == std::vector<std::string>({"run", "foo", "--icon", "folder", "bar"}),
+          "exec: %i inside a word keeps argument order");
+    app.exec = "broken \"quote";
+    check(!DesktopExec::parse(app, argv), "exec: unterminated quote is rejected");
+}
+
+void print_usage() {
+    std::cerr << "Usage: core-bench [--smoke] [--max-entries N] [--max-threads N] [--corpus DIR]... [--out FILE]\n"
+              << "  --smoke          Small sizes and invariant checks (make test)\n"
+              << "  --max-entries N  Largest synthetic catalog (default 1000000)\n"
+              << "  --max-threads N  Parallel scan scaling from 1 to N workers (default: all cores)\n"
+              << "  --corpus DIR     Directory of .desktop files (default: /usr/share/applications)\n"
+              << "  --out FILE       Write JSON lines to FILE instead of stdout\n";
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string opt = argv[i];
+        std::string arg = i + 1 < argc ? argv[i + 1] : "";
+        if (opt == "--smoke") {
+            options.smoke = true;
+            options.max_entries = std::min<size_t>(options.max_entries, 10000);
+        } else if (opt == "--max-entries" && !arg.empty()) {
+            options.max_entries = std::max(100L, atol(arg.c_str()));
+            i++;
+        } else if (opt == "--max-threads" && !arg.empty()) {
+            options.max_threads = std::max(1, atoi(arg.c_str()));
+            i++;
+        } else if (opt == "--corpus" && !arg.empty()) {
+            options.corpora.push_back(arg);
+            i++;
+        } else if (opt == "--out" && !arg.empty()) {
+            options.out_path = arg;
+            i++;
+        } else {
+            print_usage();
+            return opt == "--help" || opt == "-h" ? 0 : 2;
+        }
+    }
+    if (options.corpora.empty()) {
+        options.corpora.push_back("/usr/share/applications");
+    }
+
+    std::ofstream out_file;
+    if (!options.out_path.empty()) {
+        out_file.open(options.out_path);
+        if (!out_file) {
+            std::cerr << "core-bench: cannot write " << options.out_path << std::endl;
+            return 1;
+        }
+        results = &out_file;
+    }
+
+    char tmp_template[] = "/tmp/core-bench.XXXXXX";
+    if (!mkdtemp(tmp_template)) {
+        std::cerr << "core-bench: mkdtemp failed" << std::endl;
+        return 1;
+    }
+    std::string tmp_dir = tmp_template;
+
+    Result("meta").text("compiler", __VERSION__).number("smoke", options.smoke)
+        .number("max_entries", options.max_entries).number("max_threads", options.max_threads)
+        .number("unix_time", static_cast<double>(time(NULL)));
+
+    check_exec_parsing();
+    check_dmenu();
+    check_thread_pool();
+    bench_synthetic(options, tmp_dir);
+    for (const auto& dir : options.corpora) {
+        bench_corpus(dir, options.smoke);
+    }
+    bench_config(tmp_dir);
+    bench_usage(tmp_dir, options.smoke);
+    bench_calculator(options.smoke);
+    bench_metrics(options.smoke);
+    bench_dmenu(options);
+
+    std::error_code ec;
+    fs::remove_all(tmp_dir, ec);
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
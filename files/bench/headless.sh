@@ -0,0 +1,111 @@
+# Sourced by the bench/ scripts that drive a real daemon: private XDG
+# directories, software GL and a headless Weston or Xvfb display.
+# Set BACKEND (weston, xvfb or empty to pick one) before start_compositor;
+# a daemon whose pid is in DAEMON_PID is killed on exit.
+
+WORK=$(mktemp -d)
+COMPOSITOR_PID=""
+DAEMON_PID=""
+
+cleanup() {
+    if [ -n "$DAEMON_PID" ]; then kill "$DAEMON_PID" 2>/dev/null || true; fi
+    if [ -n "$COMPOSITOR_PID" ]; then kill "$COMPOSITOR_PID" 2>/dev/null || true; fi
+    wait 2>/dev/null || true
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# Software GL, so results do not depend on the machine's GPU
+export LIBGL_ALWAYS_SOFTWARE=1
+export GALLIUM_DRIVER=llvmpipe
+
+# Private socket, trace file, config and history; system apps still come from XDG_DATA_DIRS
+export XDG_RUNTIME_DIR="$WORK/run"
+export HOME="$WORK/home"
+export XDG_CONFIG_HOME="$HOME/.config"
+export XDG_DATA_HOME="$HOME/.local/share"
+export XDG_CACHE_HOME="$HOME/.cache"
+mkdir -m 700 "$XDG_RUNTIME_DIR"
+mkdir -p "$XDG_CONFIG_HOME"
+
+CONFIG="$XDG_CONFIG_HOME/futuristic-launcher.conf"
+TRACE="$XDG_RUNTIME_DIR/futuristic-launcher.trace"
+
+wait_for() {
+    for _ in $(seq 100); do
+        if eval "$1"; then return 0; fi
+        sleep 0.05
+    done
+    echo "$(basename "$0"): timed out waiting for: $1" >&2
+    return 1
+}
+
+start_compositor() {
+    if [ -z "$BACKEND" ]; then
+        if command -v weston >/dev/null; then
+            BACKEND=weston
+        elif command -v Xvfb >/dev/null; then
+            BACKEND=xvfb
+        else
+            echo "$(basename "$0"): needs weston or Xvfb" >&2
+            exit 1
+        fi
+    fi
+
+    case "$BACKEND" in
+        weston)
+            # Presentation feedback gives real presented timestamps
+            local headless=headless
+            if weston --help 2>&1 | grep -q headless-backend.so; then headless=headless-backend.so; fi
+            export WAYLAND_DISPLAY=headless-bench
+            export GDK_BACKEND=wayland
+            unset DISPLAY
+            weston --backend="$headless" --socket="$WAYLAND_DISPLAY" --width=1920 --height=1080 \
+                --idle-time=0 > "$WORK/compositor.log" 2>&1 &
+            COMPOSITOR_PID=$!
+            wait_for "[ -S '$XDG_RUNTIME_DIR/$WAYLAND_DISPLAY' ]"
+            ;;
+        xvfb)
+            # No compositor, so traces end at the painted frame
+            local n=99
+            while [ -e "/tmp/.X11-unix/X$n" ] || [ -e "/tmp/.X$n-lock" ]; do n=$((n + 1)); done
+            export DISPLAY=":$n"
+            export GDK_BACKEND=x11
+            unset WAYLAND_DISPLAY
+            Xvfb "$DISPLAY" -screen 0 1920x1080x24 -nolisten tcp > "$WORK/compositor.log" 2>&1 &
+            COMPOSITOR_PID=$!
+            wait_for "[ -S '/tmp/.X11-unix/X$n' ]"
+            ;;
+        *)
+            echo "$(basename "$0"): unknown backend '$BACKEND'" >&2
+            exit 2
+            ;;
+    esac
+}
+
+# Starts BINARY as the daemon, shown, and waits until it answers
+start_daemon() {
+    local binary=$1
+    rm -f "$XDG_RUNTIME_DIR"/futuristic-launcher.*
+    "$binary" --show > "$WORK/daemon.log" 2>&1 &
+    DAEMON_PID=$!
+    wait_for "'$binary' --ping 1 > /dev/null 2>&1"
+}
+
+# SIGTERM must end the daemon with status 0 within a few seconds
+stop_daemon() {
+    local status=0
+    kill -TERM "$DAEMON_PID"
+    for _ in $(seq 100); do
+        kill -0 "$DAEMON_PID" 2>/dev/null || break
+        sleep 0.05
+    done
+    if kill -0 "$DAEMON_PID" 2>/dev/null; then
+        echo "$(basename "$0"): daemon ignored SIGTERM" >&2
+        kill -KILL "$DAEMON_PID"
+        status=1
+    fi
+    wait "$DAEMON_PID" 2>/dev/null || status=$?
+    DAEMON_PID=""
+    return "$status"
+}
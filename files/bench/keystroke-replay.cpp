@@ -0,0 +1,229 @@
+/*
+ * Replays recorded search sessions (record_keystrokes=1) against an app catalog
+ *
+ * Every query goes through search(), the same call filter_apps() makes for
+ * each search-changed signal. Reports per-keystroke latency percentiles and
+ * where the app that was eventually launched ranked, so a matcher change can
+ * be judged on speed and result quality together.
+ *
+ * MIT License
+ */
+
+#include "../core/config.h"
+#include "../core/desktop.h"
+#include "../core/usage.h"
+#include "../core/catalog.h"
+#include "../core/search.h"
+#include "../core/keystrokes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string log_path;
+    std::string catalog_path;
+    std::string save_catalog_path;
+    std::string history_dir;
+    std::vector<std::string> app_dirs;
+    int repeat = 5;
+    bool learn = false;
+    bool json = false;
+};
+
+std::string data_home() {
+    const char *xdg = getenv("XDG_DATA_HOME");
+    return xdg && *xdg ? xdg : home_dir() + "/.local/share";
+}
+
+// Same order as the launcher: XDG_DATA_HOME shadows XDG_DATA_DIRS
+std::vector<std::string> application_dirs() {
+    std::vector<std::string> dirs = {data_home() + "/applications"};
+    const char *xdg = getenv("XDG_DATA_DIRS");
+    std::istringstream system_dirs(xdg && *xdg ? xdg : "/usr/local/share:/usr/share");
+    for (std::string dir; std::getline(system_dirs, dir, ':');) {
+        if (!dir.empty()) dirs.push_back(dir + "/applications");
+    }
+    return dirs;
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, index == 0 ? 0 : index - 1)];
+}
+
+// 1-based position of slot in results, 0 when it is not listed
+size_t rank_of(const std::vector<uint32_t>& results, int slot) {
+    auto it = std::find(results.begin(), results.end(), static_cast<uint32_t>(slot));
+    return it == results.end() ? 0 : static_cast<size_t>(it - results.begin()) + 1;
+}
+
+void print_usage() {
+    std::cerr << "Usage: keystroke-replay [OPTIONS]\n"
+              << "  --log FILE           Recorded sessions (default: $XDG_DATA_HOME/futuristic-launcher/keystrokes.log)\n"
+              << "  --catalog FILE       Catalog snapshot to replay against\n"
+              << "  --apps DIR           Scan DIR for .desktop files instead (repeatable; default: XDG dirs)\n"
+              << "  --save-catalog FILE  Write the catalog that was used, for later --catalog runs\n"
+              << "  --history DIR        Launch history to rank with (read only; default: none)\n"
+              << "  --learn              Record each replayed launch into the history as it happens\n"
+              << "  --repeat N           Replay every session N times for latency (default 5)\n"
+              << "  --json               One JSON object on stdout instead of the text summary\n";
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    options.log_path = data_home() + "/futuristic-launcher/keystrokes.log";
+
+    for (int i = 1; i < argc; i++) {
+        std::string opt = argv[i];
+        std::string arg = i + 1 < argc ? argv[i + 1] : "";
+        bool takes_arg = opt == "--log" || opt == "--catalog" || opt == "--apps" ||
+                         opt == "--save-catalog" || opt == "--history" || opt == "--repeat";
+        if (takes_arg && arg.empty()) {
+            print_usage();
+            return 2;
+        }
+        if (opt == "--log") options.log_path = arg;
+        else if (opt == "--catalog") options.catalog_path = arg;
+        else if (opt == "--apps") options.app_dirs.push_back(arg);
+        else if (opt == "--save-catalog") options.save_catalog_path = arg;
+        else if (opt == "--history") options.history_dir = arg;
+        else if (opt == "--repeat") options.repeat = std::max(1, atoi(arg.c_str()));
+        else if (opt == "--learn") options.learn = true;
+        else if (opt == "--json") options.json = true;
+        else {
+            print_usage();
+            return opt == "--help" || opt == "-h" ? 0 : 2;
+        }
+        if (takes_arg) i++;
+    }
+
+    std::vector<KeystrokeSession> sessions = read_keystroke_log(options.log_path);
+    if (sessions.empty()) {
+        std::cerr << "keystroke-replay: no sessions in " << options.log_path << std::endl;
+        return 1;
+    }
+
+    std::vector<DesktopApp> apps;
+    if (!options.catalog_path.empty()) {
+        apps = read_catalog_snapshot(options.catalog_path);
+    } else {
+        apps = scan_desktop_files(options.app_dirs.empty() ? application_dirs() : options.app_dirs);
+    }
+    if (!options.save_catalog_path.empty() && !write_catalog_snapshot(options.save_catalog_path, apps)) {
+        std::cerr << "keystroke-replay: cannot write " << options.save_catalog_path << std::endl;
+        return 1;
+    }
+
+    Config config;
+    UsageJournal usage;
+    if (!options.history_dir.empty()) {
+        usage.load(options.history_dir, config, true);
+    }
+    AppCatalog catalog;
+    AppIndex index;
+    build_catalog(apps, usage, config.favorites, catalog, index);
+
+    // Latency over all repeats; quality from the first pass, before warm caches matter
+    std::vector<double> latencies;
+    size_t keystrokes = 0, late = 0;
+    size_t launched = 0, missing = 0, rank1 = 0, top3 = 0;
+    double reciprocal_sum = 0.0;
+    size_t reached_top = 0, keystrokes_to_top_sum = 0;
+    std::vector<uint32_t> results;
+
+    for (int pass = 0; pass < options.repeat; pass++) {
+        for (const auto& session : sessions) {
+            int slot = session.launched_id.empty() ? -1 : index.find(session.launched_id);
+            size_t final_rank = 0, first_top = 0;
+
+            std::string previous;
+            for (size_t k = 0; k < session.queries.size(); k++) {
+                const auto& [at_ms, query] = session.queries[k];
+                if (k > 0 && query == previous) continue;  // search-changed would not fire
+                previous = query;
+
+                auto start = Clock::now();
+                search(catalog, index, usage, query, results);
+                double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+                latencies.push_back(us);
+
+                // Results that arrive after the next keystroke are never seen
+                int64_t next_ms = k + 1 < session.queries.size() ? session.queries[k + 1].first : -1;
+                if (next_ms >= 0 && us > (next_ms - at_ms) * 1000.0) late++;
+
+                if (pass == 0) {
+                    keystrokes++;
+                    if (slot >= 0) {
+                        final_rank = rank_of(results, slot);
+                        if (final_rank == 1 && first_top == 0) first_top = k + 1;
+                    }
+                }
+            }
+
+            if (pass != 0 || session.launched_id.empty()) continue;
+            launched++;
+            if (slot < 0) {
+                missing++;
+                continue;
+            }
+            rank1 += final_rank == 1;
+            top3 += final_rank >= 1 && final_rank <= 3;
+            reciprocal_sum += final_rank ? 1.0 / final_rank : 0.0;
+            if (first_top) {
+                reached_top++;
+                keystrokes_to_top_sum += first_top;
+            }
+            if (options.learn) {
+                usage.record(session.launched_id, session.queries.back().second);
+                catalog.frecency[slot] = usage.usage(session.launched_id)->frecency;
+            }
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    size_t ranked = launched - missing;
+    double rank1_pct = ranked ? 100.0 * rank1 / ranked : 0.0;
+    double top3_pct = ranked ? 100.0 * top3 / ranked : 0.0;
+    double mrr = ranked ? reciprocal_sum / ranked : 0.0;
+    double to_top = reached_top ? static_cast<double>(keystrokes_to_top_sum) / reached_top : 0.0;
+
+    if (options.json) {
+        std::cout << std::setprecision(6)
+                  << "{\"sessions\":" << sessions.size() << ",\"catalog\":" << catalog.size()
+                  << ",\"launched\":" << launched << ",\"missing\":" << missing
+                  << ",\"keystrokes\":" << keystrokes << ",\"repeat\":" << options.repeat
+                  << ",\"p50_us\":" << percentile(latencies, 50) << ",\"p95_us\":" << percentile(latencies, 95)
+                  << ",\"p99_us\":" << percentile(latencies, 99)
+                  << ",\"max_us\":" << (latencies.empty() ? 0.0 : latencies.back())
+                  << ",\"late_keystrokes\":" << late
+                  << ",\"rank1_pct\":" << rank1_pct << ",\"top3_pct\":" << top3_pct
+                  << ",\"mrr\":" << mrr << ",\"keystrokes_to_top\":" << to_top << "}\n";
+        return 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "sessions " << sessions.size() << " (" << launched << " launched, " << missing
+              << " launched app not in catalog), " << keystrokes << " keystrokes x " << options.repeat
+              << ", catalog " << catalog.size() << " apps\n"
+              << "search latency  p50 " << percentile(latencies, 50) << " us  p95 " << percentile(latencies, 95)
+              << " us  p99 " << percentile(latencies, 99) << " us  max "
+              << (latencies.empty() ? 0.0 : latencies.back()) << " us  late " << late << "\n"
+              << "launched app    rank 1 " << rank1_pct << "%  top 3 " << top3_pct << "%  MRR "
+              << std::setprecision(3) << mrr << std::setprecision(1)
+              << "  keystrokes to rank 1 " << to_top << "\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+#!/bin/bash
+# Signal and toggle stress: floods a daemon with SIGUSR1 and "toggle" control
+# requests (thousands per second each, from several senders at once), then
+# requires it to still answer --ping and to exit cleanly on SIGTERM. A daemon
+# that does real work in an async signal handler deadlocks here.
+#
+# Usage: bench/signal-stress.sh [--backend weston|xvfb] [--seconds N] [--min-rate N] BINARY...
+
+set -euo pipefail
+
+BACKEND=""
+SECONDS_PER_RUN=5
+MIN_RATE=1000
+BINARIES=()
+
+usage() {
+    echo "Usage: $0 [--backend weston|xvfb] [--seconds N] [--min-rate N] BINARY..."
+    echo "  --backend   Headless Weston (default when installed) or Xvfb"
+    echo "  --seconds   Flood duration per binary (default 5)"
+    echo "  --min-rate  Toggle replies per second required during the flood (default 1000)"
+}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --backend) BACKEND=$2; shift 2 ;;
+        --seconds) SECONDS_PER_RUN=$2; shift 2 ;;
+        --min-rate) MIN_RATE=$2; shift 2 ;;
+        -h|--help) usage; exit 0 ;;
+        -*) usage >&2; exit 2 ;;
+        *) BINARIES+=("$(realpath "$1")"); shift ;;
+    esac
+done
+
+if [ ${#BINARIES[@]} -eq 0 ]; then
+    usage >&2
+    exit 2
+fi
+
+source "$(dirname "$0")/headless.sh"
+
+# Toggling redraws on every request; keep the frames cheap and skip file I/O
+cat > "$CONFIG" <<EOF
+render_policy=static
+prefetch_apps=0
+metrics_interval_s=0
+EOF
+
+# Sends SIGUSR1 until the deadline; prints how many were sent
+send_signals() {
+    local pid=$1 deadline=$2 sent=0
+    while [ "$(date +%s%N)" -lt "$deadline" ]; do
+        for _ in $(seq 100); do
+            kill -USR1 "$pid" 2>/dev/null || { echo "$sent"; return; }
+            sent=$((sent + 1))
+        done
+    done
+    echo "$sent"
+}
+
+# Pipelines toggles on a connection, reconnecting every 200 requests so accepts
+# are stressed too; prints how many were answered with "ok"
+send_toggles() {
+    python3 - "$XDG_RUNTIME_DIR/futuristic-launcher.sock" "$1" <<'PY'
+import socket, sys, time
+
+path, deadline = sys.argv[1], int(sys.argv[2]) / 1e9
+answered = 0
+try:
+    while time.clock_gettime(time.CLOCK_REALTIME) < deadline:
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.settimeout(5)
+        sock.connect(path)
+        stream = sock.makefile("rw")
+        for _ in range(20):
+            stream.write("toggle\n" * 10)
+            stream.flush()
+            for _ in range(10):
+                if stream.readline() == "ok\n":
+                    answered += 1
+        sock.close()
+except OSError as error:
+    print("send_toggles: %s" % error, file=sys.stderr)
+print(answered)
+PY
+}
+
+start_compositor
+failures=0
+for binary in "${BINARIES[@]}"; do
+    echo "$(basename "$binary") ($BACKEND, ${SECONDS_PER_RUN}s)"
+    start_daemon "$binary"
+
+    deadline=$(( $(date +%s%N) + SECONDS_PER_RUN * 1000000000 ))
+    send_signals "$DAEMON_PID" "$deadline" > "$WORK/signals.1" &
+    signal_pid1=$!
+    send_signals "$DAEMON_PID" "$deadline" > "$WORK/signals.2" &
+    signal_pid2=$!
+    send_toggles "$deadline" > "$WORK/toggles.1" &
+    toggle_pid1=$!
+    send_toggles "$deadline" > "$WORK/toggles.2" &
+    toggle_pid2=$!
+    wait "$signal_pid1" "$signal_pid2" "$toggle_pid1" "$toggle_pid2" || true
+
+    signals=$(( $(cat "$WORK/signals.1") + $(cat "$WORK/signals.2") ))
+    toggles=$(( $(cat "$WORK/toggles.1") + $(cat "$WORK/toggles.2") ))
+    echo "  SIGUSR1 sent:  $signals ($((signals / SECONDS_PER_RUN))/s)"
+    echo "  toggles ok:    $toggles ($((toggles / SECONDS_PER_RUN))/s)"
+    if [ $((toggles / SECONDS_PER_RUN)) -lt "$MIN_RATE" ]; then
+        echo "  FAIL: fewer than $MIN_RATE toggle replies per second" >&2
+        failures=$((failures + 1))
+    fi
+
+    # Still responsive once the flood stops
+    if pings=$(timeout 10 "$binary" --ping 100); then
+        echo "  $pings"
+    else
+        echo "  FAIL: daemon stopped answering --ping" >&2
+        failures=$((failures + 1))
+    fi
+
+    if ! stop_daemon; then
+        echo "  FAIL: daemon did not exit cleanly on SIGTERM; log follows" >&2
+        cat "$WORK/daemon.log" >&2
+        failures=$((failures + 1))
+    fi
+done
+
+exit $((failures > 0))
@@ -0,0 +1,125 @@
+#!/bin/bash
+# UI latency harness: runs launcher builds in a headless compositor with
+# software GL and measures toggle-to-presented and keystroke-to-presented
+# latency from the daemon's frame-clock traces.
+#
+# Usage: bench/ui-latency.sh [--backend weston|xvfb] [--shows N] [--query TEXT]
+#                            [--out FILE] BINARY...
+
+set -euo pipefail
+
+BACKEND=""
+SHOWS=20
+QUERY="terminal"
+OUT=""
+BINARIES=()
+
+usage() {
+    echo "Usage: $0 [--backend weston|xvfb] [--shows N] [--query TEXT] [--out FILE] BINARY..."
+    echo "  --backend   Headless Weston (default when installed) or Xvfb"
+    echo "  --shows     Show/type/hide cycles per binary (default 20)"
+    echo "  --query     Typed one key at a time, then erased with BackSpace (default terminal)"
+    echo "  --out       Append one JSON object per binary and metric to FILE"
+}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --backend) BACKEND=$2; shift 2 ;;
+        --shows) SHOWS=$2; shift 2 ;;
+        --query) QUERY=$2; shift 2 ;;
+        --out) OUT=$2; shift 2 ;;
+        -h|--help) usage; exit 0 ;;
+        -*) usage >&2; exit 2 ;;
+        *) BINARIES+=("$(realpath "$1")"); shift ;;
+    esac
+done
+
+if [ ${#BINARIES[@]} -eq 0 ]; then
+    usage >&2
+    exit 2
+fi
+
+source "$(dirname "$0")/headless.sh"
+
+# Keep the shader running so every change reaches a frame; no prefetch I/O in the timings
+cat > "$CONFIG" <<EOF
+render_policy=full
+prefetch_apps=0
+show_budget_ms=1000
+EOF
+
+# stdin: "key total=... filter=..." lines; prints "samples p50 p95 p99 max" of FIELD
+percentiles() {
+    local field=$1
+    sed -n "s/.* $field=\([0-9-]*\).*/\1/p" | sort -n | awk '
+        { v[NR] = $1 }
+        function pct(p,   i) { i = int(p / 100 * NR + 0.999999); return v[i < 1 ? 1 : i] }
+        END {
+            if (NR == 0) { print 0, 0, 0, 0, 0; exit }
+            print NR, pct(50), pct(95), pct(99), v[NR]
+        }'
+}
+
+report() {
+    local binary=$1 gtk=$2 metric lines
+    for metric in show key; do
+        lines=$(grep "^$metric " "$TRACE" || true)
+        read -r samples p50 p95 p99 max < <(percentiles total <<< "$lines")
+        printf "%-32s gtk%-2s %-7s %-5s %8s %8s %8s %8s %8s\n" \
+            "$(basename "$binary")" "$gtk" "$BACKEND" "$metric" "$samples" "$p50" "$p95" "$p99" "$max"
+        if [ -n "$OUT" ]; then
+            printf '{"bench":"ui","binary":"%s","gtk":%s,"backend":"%s","metric":"%s","samples":%s,"p50_us":%s,"p95_us":%s,"p99_us":%s,"max_us":%s}\n' \
+                "$(basename "$binary")" "$gtk" "$BACKEND" "$metric" "$samples" "$p50" "$p95" "$p99" "$max" >> "$OUT"
+        fi
+    done
+
+    # Where keystroke time goes, p50 per stage
+    local stage stages=""
+    lines=$(grep "^key " "$TRACE" || true)
+    for stage in filter list paint present; do
+        stages+=" $stage=$(percentiles "$stage" <<< "$lines" | cut -d' ' -f2)"
+    done
+    echo "    key stages p50 us:$stages"
+}
+
+run_binary() {
+    local binary=$1 gtk i c
+    start_daemon "$binary"
+    gtk=$("$binary" --stats | sed -n 's/^gtk=//p')
+    "$binary" --hide
+    sleep 0.5
+
+    # Drop the cold-start show
+    : > "$TRACE"
+
+    for ((i = 0; i < SHOWS; i++)); do
+        # A client with no daemon to talk to would start one in the foreground
+        if ! kill -0 "$DAEMON_PID" 2>/dev/null; then
+            echo "ui-latency: $(basename "$binary") exited; log follows" >&2
+            cat "$WORK/daemon.log" >&2
+            exit 1
+        fi
+        "$binary" --show
+        sleep 0.3
+        for ((c = 0; c < ${#QUERY}; c++)); do
+            "$binary" --key "${QUERY:c:1}"
+            sleep 0.1
+        done
+        for ((c = 0; c < ${#QUERY}; c++)); do
+            "$binary" --key BackSpace
+            sleep 0.1
+        done
+        "$binary" --hide
+        sleep 0.3
+    done
+
+    stop_daemon || true
+
+    report "$binary" "$gtk"
+}
+
+start_compositor
+printf "%-32s %-5s %-7s %-5s %8s %8s %8s %8s %8s\n" binary gtk backend event samples p50_us p95_us p99_us max_us
+for binary in "${BINARIES[@]}"; do
+    run_binary "$binary"
+done
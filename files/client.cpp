@@ -0,0 +1,49 @@
+// futuristic-launcher: hands one command to the running daemon over its control
+// socket. Linked against the core only, so a toggle never maps GTK; the GTK
+// binary (futuristic-launcher-daemon) is exec'd only when no daemon answers.
+#include "core/control.h"
+#include "core/profile.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <libgen.h>
+#include <unistd.h>
+
+static constexpr const char *DAEMON_NAME = "futuristic-launcher-daemon";
+
+int main(int argc, char *argv[]) {
+    int64_t client_start = monotonic_us();
+
+    ControlOptions options = parse_control_options(argc, argv);
+    if (options.exit_status >= 0) {
+        return options.exit_status;
+    }
+    if (options.ping_count > 0) {
+        return control_measure_latency(options.ping_count);
+    }
+
+    int status = control_forward(options, client_start);
+    if (status >= 0) {
+        return status;
+    }
+
+    // Become the daemon; it keeps this start time for the show trace
+    setenv("FUTURISTIC_LAUNCHER_CLIENT_START", std::to_string(client_start).c_str(), 1);
+
+    // Prefer the daemon installed next to this binary, then $PATH
+    char self[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (n > 0) {
+        self[n] = '\0';
+        std::string sibling = std::string(dirname(self)) + "/" + DAEMON_NAME;
+        execv(sibling.c_str(), argv);
+    }
+    execvp(DAEMON_NAME, argv);
+
+    std::cerr << "futuristic-launcher: cannot run " << DAEMON_NAME << ": " << strerror(errno) << std::endl;
+    return 1;
+}
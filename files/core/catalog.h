@@ -0,0 +1,224 @@
+// Resident app catalog and its desktop-ID index
+#ifndef FUTURISTIC_CORE_CATALOG_H
+#define FUTURISTIC_CORE_CATALOG_H
+
+#include "desktop.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Offset and length of a NUL-terminated string inside a StringArena
+struct StringRef {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+// All catalog strings in one buffer; values that repeat across apps are interned
+class StringArena {
+    std::string data;
+    std::unordered_map<std::string, StringRef> interned;
+    
+public:
+    StringRef add(std::string_view value) {
+        StringRef ref{static_cast<uint32_t>(data.size()), static_cast<uint32_t>(value.size())};
+        data.append(value);
+        data.push_back('\0');
+        return ref;
+    }
+    
+    StringRef intern(std::string_view value) {
+        auto [it, inserted] = interned.emplace(std::string(value), StringRef());
+        if (inserted) {
+            it->second = add(value);
+        }
+        return it->second;
+    }
+    
+    // The view is NUL-terminated, so data() can go straight to C APIs
+    std::string_view view(StringRef ref) const {
+        return std::string_view(data.data() + ref.offset, ref.length);
+    }
+    
+    void clear() {
+        data.clear();
+        interned.clear();
+    }
+    
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+    }
+    
+    size_t bytes() const {
+        return data.capacity();
+    }
+};
+
+// Struct-of-arrays app catalog. Search and ranking walk the hot arrays only;
+// everything else is read when an app is drawn or launched.
+class AppCatalog {
+    StringArena strings;
+    
+    // Hot
+    std::vector<StringRef> names;
+    std::vector<StringRef> comments;
+    
+    // Cold
+    std::vector<StringRef> ids;
+    std::vector<StringRef> argvs;  // arguments separated by NUL
+    std::vector<StringRef> icons;
+    std::vector<StringRef> categories_;
+    
+public:
+    // Hot ranking state, indexed by slot
+    std::vector<double> frecency;
+    std::vector<uint8_t> favorite;
+    
+    // Cold usage state
+    std::vector<int> launch_count;
+    std::vector<time_t> last_launch;
+    
+    size_t size() const { return names.size(); }
+    bool empty() const { return names.empty(); }
+    
+    std::string_view id(uint32_t slot) const { return strings.view(ids[slot]); }
+    std::string_view name(uint32_t slot) const { return strings.view(names[slot]); }
+    std::string_view comment(uint32_t slot) const { return strings.view(comments[slot]); }
+    std::string_view icon(uint32_t slot) const { return strings.view(icons[slot]); }
+    std::string_view categories(uint32_t slot) const { return strings.view(categories_[slot]); }
+    
+    // argv[0]
+    std::string_view command(uint32_t slot) const {
+        std::string_view packed = strings.view(argvs[slot]);
+        return packed.substr(0, packed.find('\0'));
+    }
+    
+    std::vector<std::string> argv(uint32_t slot) const {
+        std::string_view packed = strings.view(argvs[slot]);
+        std::vector<std::string> args;
+        for (size_t start = 0; start <= packed.size();) {
+            size_t end = std::min(packed.find('\0', start), packed.size());
+            args.emplace_back(packed.substr(start, end - start));
+            start = end + 1;
+        }
+        return args;
+    }
+    
+    void reserve(size_t count) {
+        for (auto *refs : {&names, &comments, &ids, &argvs, &icons, &categories_}) {
+            refs->reserve(count);
+        }
+        frecency.reserve(count);
+        favorite.reserve(count);
+        launch_count.reserve(count);
+        last_launch.reserve(count);
+    }
+    
+    uint32_t add(const DesktopApp& app) {
+        names.push_back(strings.add(app.name));
+        comments.push_back(strings.add(app.comment));
+        ids.push_back(strings.add(app.id));
+        std::string packed;
+        for (const auto& arg : app.argv) {
+            if (!packed.empty()) packed += '\0';
+            packed += arg;
+        }
+        argvs.push_back(strings.add(packed));
+        icons.push_back(strings.intern(app.icon));
+        categories_.push_back(strings.intern(app.categories));
+        frecency.push_back(app.frecency);
+        favorite.push_back(app.is_favorite ? 1 : 0);
+        launch_count.push_back(app.launch_count);
+        last_launch.push_back(app.last_launch);
+        return static_cast<uint32_t>(names.size() - 1);
+    }
+    
+    void clear() {
+        strings.clear();
+        for (auto *refs : {&names, &comments, &ids, &argvs, &icons, &categories_}) {
+            refs->clear();
+        }
+        frecency.clear();
+        favorite.clear();
+        launch_count.clear();
+        last_launch.clear();
+    }
+    
+    void shrink_to_fit() {
+        strings.shrink_to_fit();
+        for (auto *refs : {&names, &comments, &ids, &argvs, &icons, &categories_}) {
+            refs->shrink_to_fit();
+        }
+        frecency.shrink_to_fit();
+        favorite.shrink_to_fit();
+        launch_count.shrink_to_fit();
+        last_launch.shrink_to_fit();
+    }
+    
+    // Heap bytes held by the catalog (arena, arrays; not the intern table)
+    size_t memory_bytes() const {
+        size_t bytes = strings.bytes();
+        for (auto *refs : {&names, &comments, &ids, &argvs, &icons, &categories_}) {
+            bytes += refs->capacity() * sizeof(StringRef);
+        }
+        bytes += frecency.capacity() * sizeof(double) + favorite.capacity() +
+                 launch_count.capacity() * sizeof(int) + last_launch.capacity() * sizeof(time_t);
+        return bytes;
+    }
+};
+
+// Open-addressing (linear probing) index from desktop-file ID to catalog slot.
+// Slots only hold the hash and the slot number; keys are compared in place.
+class AppIndex {
+    struct Slot {
+        uint32_t hash = 0;
+        int32_t index = -1;
+    };
+    
+    const AppCatalog *catalog = nullptr;
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    
+    // FNV-1a
+    static uint32_t hash_id(std::string_view id) {
+        uint32_t hash = 2166136261u;
+        for (unsigned char c : id) {
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash;
+    }
+    
+public:
+    // Load factor stays at or below 0.5
+    void build(const AppCatalog& apps) {
+        catalog = &apps;
+        size_t capacity = 16;
+        while (capacity < apps.size() * 2) capacity <<= 1;
+        slots.assign(capacity, Slot());
+        mask = capacity - 1;
+        
+        for (size_t i = 0; i < apps.size(); i++) {
+            uint32_t hash = hash_id(apps.id(i));
+            size_t pos = hash & mask;
+            while (slots[pos].index >= 0) pos = (pos + 1) & mask;
+            slots[pos].hash = hash;
+            slots[pos].index = static_cast<int32_t>(i);
+        }
+    }
+    
+    int find(std::string_view id) const {
+        if (slots.empty()) return -1;
+        uint32_t hash = hash_id(id);
+        for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+            const Slot& slot = slots[pos];
+            if (slot.index < 0) return -1;
+            if (slot.hash == hash && catalog->id(slot.index) == id) return slot.index;
+        }
+    }
+};
+
+#endif
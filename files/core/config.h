@@ -0,0 +1,373 @@
+// Launcher settings: the flat key=value file and its background writer
+#ifndef FUTURISTIC_CORE_CONFIG_H
+#define FUTURISTIC_CORE_CONFIG_H
+
+#include "profile.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+enum Theme {
+    THEME_BLUE,
+    THEME_PURPLE,
+    THEME_GREEN,
+    THEME_RED,
+    THEME_ORANGE,
+    THEME_CYAN,
+    THEME_MORPH
+};
+
+
+enum RenderPolicy {
+    POLICY_AUTO,
+    POLICY_FULL,
+    POLICY_REDUCED,
+    POLICY_STATIC
+};
+
+
+// $HOME, falling back to the password database like g_get_home_dir()
+inline std::string home_dir() {
+    const char *home = getenv("HOME");
+    if (home && *home) return home;
+    struct passwd *entry = getpwuid(getuid());
+    return entry && entry->pw_dir ? entry->pw_dir : "/";
+}
+
+struct Config {
+    Theme current_theme = THEME_BLUE;
+    int icon_size = 96;
+    float transparency = 0.90f;
+    bool debug_overlay = false;
+    
+    // Power-aware render governor
+    RenderPolicy render_policy = POLICY_AUTO;
+    int reduced_fps = 20;
+    int low_battery_percent = 20;
+    int thermal_reduce_c = 75;
+    int thermal_static_c = 90;
+    int pressure_reduce = 40;
+    int governor_hold_samples = 3;
+    
+    // Regression budget for toggle-to-first-frame latency
+    int show_budget_ms = 100;
+    
+    // Launch history ranking
+    int frecency_half_life_days = 14;
+    
+    // Page-cache warming for likely launches
+    int prefetch_apps = 5;
+    int prefetch_budget_mb = 64;
+    
+    // Prometheus textfile in $XDG_RUNTIME_DIR; 0 turns it off
+    int metrics_interval_s = 15;
+    
+    // --dmenu keeps at most this much stdin; later lines are dropped
+    int dmenu_max_mb = 256;
+    // Workers for scoring large --dmenu inputs; 0 uses every core
+    int scoring_threads = 0;
+    
+    // Opt-in: search sessions are appended to keystrokes.log for replay
+    bool record_keystrokes = false;
+    
+    std::set<std::string> favorites;  // desktop-file IDs (older configs used names)
+    std::map<std::string, int> launch_counts;
+    std::map<std::string, time_t> last_launches;
+    
+    bool validate() {
+        if (icon_size < 16 || icon_size > 256) icon_size = 96;
+        if (transparency < 0.0f || transparency > 1.0f) transparency = 0.98f;
+        if (current_theme < THEME_BLUE || current_theme > THEME_MORPH) current_theme = THEME_BLUE;
+        if (reduced_fps < 1 || reduced_fps > 60) reduced_fps = 20;
+        if (low_battery_percent < 0 || low_battery_percent > 100) low_battery_percent = 20;
+        if (thermal_static_c <= thermal_reduce_c) thermal_static_c = thermal_reduce_c + 15;
+        if (governor_hold_samples < 1) governor_hold_samples = 1;
+        if (show_budget_ms < 1) show_budget_ms = 100;
+        if (frecency_half_life_days < 1) frecency_half_life_days = 14;
+        if (prefetch_apps < 0) prefetch_apps = 0;
+        if (prefetch_budget_mb < 0) prefetch_budget_mb = 64;
+        if (metrics_interval_s < 0) metrics_interval_s = 15;
+        if (dmenu_max_mb < 1) dmenu_max_mb = 256;
+        if (scoring_threads < 0) scoring_threads = 0;
+        return true;
+    }
+    
+    void load() {
+        load_from(path());
+    }
+    
+    void load_from(const std::string& config_path) {
+        PROFILE_SCOPE("Config::load");
+        std::ifstream file(config_path);
+        if (!file.is_open()) return;
+        
+        std::string line;
+        int error_count = 0;
+        
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            
+            if (value.empty()) continue;
+            
+            try {
+                if (key == "theme") {
+                    int theme_val = std::stoi(value);
+                    if (theme_val >= 0 && theme_val <= 6) {
+                        current_theme = static_cast<Theme>(theme_val);
+                    }
+                } else if (key == "icon_size") {
+                    int size = std::stoi(value);
+                    if (size > 0 && size <= 256) {
+                        icon_size = size;
+                    }
+                } else if (key == "transparency") {
+                    float trans = std::stof(value);
+                    if (trans >= 0.0f && trans <= 1.0f) {
+                        transparency = trans;
+                    }
+                } else if (key == "debug_overlay") {
+                    debug_overlay = (value == "1" || value == "true");
+                } else if (key == "render_policy") {
+                    if (value == "auto") render_policy = POLICY_AUTO;
+                    else if (value == "full") render_policy = POLICY_FULL;
+                    else if (value == "reduced") render_policy = POLICY_REDUCED;
+                    else if (value == "static") render_policy = POLICY_STATIC;
+                } else if (key == "reduced_fps") {
+                    reduced_fps = std::stoi(value);
+                } else if (key == "low_battery_percent") {
+                    low_battery_percent = std::stoi(value);
+                } else if (key == "thermal_reduce_c") {
+                    thermal_reduce_c = std::stoi(value);
+                } else if (key == "thermal_static_c") {
+                    thermal_static_c = std::stoi(value);
+                } else if (key == "pressure_reduce") {
+                    pressure_reduce = std::stoi(value);
+                } else if (key == "governor_hold_samples") {
+                    governor_hold_samples = std::stoi(value);
+                } else if (key == "show_budget_ms") {
+                    show_budget_ms = std::stoi(value);
+                } else if (key == "frecency_half_life_days") {
+                    frecency_half_life_days = std::stoi(value);
+                } else if (key == "prefetch_apps") {
+                    prefetch_apps = std::stoi(value);
+                } else if (key == "prefetch_budget_mb") {
+                    prefetch_budget_mb = std::stoi(value);
+                } else if (key == "metrics_interval_s") {
+                    metrics_interval_s = std::stoi(value);
+                } else if (key == "dmenu_max_mb") {
+                    dmenu_max_mb = std::stoi(value);
+                } else if (key == "scoring_threads") {
+                    scoring_threads = std::stoi(value);
+                } else if (key == "record_keystrokes") {
+                    record_keystrokes = (value == "1" || value == "true");
+                } else if (key == "favorite") {
+                    favorites.insert(value);
+                } else if (key.length() > 6 && key.substr(0, 6) == "count_") {
+                    std::string app_name = key.substr(6);
+                    int count = std::stoi(value);
+                    if (count >= 0) {
+                        launch_counts[app_name] = count;
+                    }
+                } else if (key.length() > 5 && key.substr(0, 5) == "last_") {
+                    std::string app_name = key.substr(5);
+                    long timestamp = std::stol(value);
+                    if (timestamp >= 0) {
+                        last_launches[app_name] = timestamp;
+                    }
+                }
+            } catch (...) {
+                error_count++;
+                continue;
+            }
+        }
+        
+        file.close();
+        
+        if (error_count > 10) {
+            std::string backup_path = config_path + ".backup";
+            std::rename(config_path.c_str(), backup_path.c_str());
+        }
+        
+        validate();
+    }
+    
+    static std::string path() {
+        return home_dir() + "/.config/futuristic-launcher.conf";
+    }
+    
+    std::string serialize() const {
+        PROFILE_SCOPE("Config::serialize");
+        std::ostringstream file;
+        
+        file << "# Futuristic Launcher Configuration\n";
+        file << "theme=" << static_cast<int>(current_theme) << "\n";
+        file << "icon_size=" << icon_size << "\n";
+        file << "transparency=" << transparency << "\n";
+        file << "debug_overlay=" << (debug_overlay ? 1 : 0) << "\n";
+        
+        static const char* policy_names[] = {"auto", "full", "reduced", "static"};
+        file << "render_policy=" << policy_names[render_policy] << "\n";
+        file << "reduced_fps=" << reduced_fps << "\n";
+        file << "low_battery_percent=" << low_battery_percent << "\n";
+        file << "thermal_reduce_c=" << thermal_reduce_c << "\n";
+        file << "thermal_static_c=" << thermal_static_c << "\n";
+        file << "pressure_reduce=" << pressure_reduce << "\n";
+        file << "governor_hold_samples=" << governor_hold_samples << "\n";
+        file << "show_budget_ms=" << show_budget_ms << "\n";
+        file << "frecency_half_life_days=" << frecency_half_life_days << "\n";
+        file << "prefetch_apps=" << prefetch_apps << "\n";
+        file << "prefetch_budget_mb=" << prefetch_budget_mb << "\n";
+        file << "metrics_interval_s=" << metrics_interval_s << "\n";
+        file << "dmenu_max_mb=" << dmenu_max_mb << "\n";
+        file << "scoring_threads=" << scoring_threads << "\n";
+        file << "record_keystrokes=" << (record_keystrokes ? 1 : 0) << "\n";
+        
+        for (const auto& fav : favorites) {
+            file << "favorite=" << fav << "\n";
+        }
+        
+        for (const auto& [app, count] : launch_counts) {
+            file << "count_" << app << "=" << count << "\n";
+        }
+        
+        for (const auto& [app, last] : last_launches) {
+            file << "last_" << app << "=" << last << "\n";
+        }
+        
+        return file.str();
+    }
+    
+    // Synchronous; the launcher normally goes through ConfigWriter
+    bool save() const {
+        return write_file_atomic(path(), serialize());
+    }
+    
+    // Temp file, fsync, rename: a crash leaves either the old or the new file.
+    // The temp name is unique, so two processes saving at once cannot mix writes.
+    static bool write_file_atomic(const std::string& target, const std::string& contents) {
+        PROFILE_SCOPE("Config::write_file_atomic");
+        std::string dir = fs::path(target).parent_path().string();
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        
+        std::string tmp = target + ".XXXXXX";
+        int fd = mkostemp(tmp.data(), O_CLOEXEC);
+        if (fd < 0) return false;
+        fchmod(fd, 0644);
+        
+        size_t done = 0;
+        while (done < contents.size()) {
+            ssize_t n = write(fd, contents.data() + done, contents.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += n;
+        }
+        
+        bool ok = done == contents.size() && fsync(fd) == 0;
+        close(fd);
+        if (!ok || rename(tmp.c_str(), target.c_str()) != 0) {
+            unlink(tmp.c_str());
+            return false;
+        }
+        
+        // Persist the rename itself
+        int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+        return true;
+    }
+};
+
+// Writes config snapshots on a background thread, at most once per interval
+class ConfigWriter {
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::string pending;
+    bool has_pending = false;
+    bool stopping = false;
+    std::thread worker;  // last, so the state above exists before it starts
+    
+    static constexpr auto MIN_INTERVAL = std::chrono::milliseconds(1000);
+    
+    void run() {
+        auto last_write = std::chrono::steady_clock::time_point();
+        std::unique_lock<std::mutex> lock(mutex);
+        
+        while (true) {
+            wake.wait(lock, [this] { return has_pending || stopping; });
+            if (!has_pending) break;
+            
+            // Coalesce bursts: later submits replace the pending snapshot
+            if (!stopping) {
+                wake.wait_until(lock, last_write + MIN_INTERVAL, [this] { return stopping; });
+            }
+            
+            std::string contents;
+            contents.swap(pending);
+            has_pending = false;
+            
+            lock.unlock();
+            if (!Config::write_file_atomic(Config::path(), contents)) {
+                std::cerr << "Failed to write " << Config::path() << std::endl;
+            }
+            last_write = std::chrono::steady_clock::now();
+            lock.lock();
+        }
+    }
+
+public:
+    ConfigWriter() : worker(&ConfigWriter::run, this) {}
+    
+    ~ConfigWriter() {
+        stop();
+    }
+    
+    void submit(std::string contents) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = std::move(contents);
+            has_pending = true;
+        }
+        wake.notify_one();
+    }
+    
+    // Writes anything still pending, then joins the thread
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (worker.joinable()) worker.join();
+    }
+};
+
+#endif
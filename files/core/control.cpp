@@ -0,0 +1,191 @@
+#include "control.h"
+#include "profile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ControlOptions parse_control_options(int argc, char *argv[]) {
+    ControlOptions options;
+    if (argc < 2) return options;
+
+    std::string opt = argv[1];
+    std::string arg = argc > 2 ? argv[2] : "";
+    if (opt == "--toggle" || opt == "--show" || opt == "--hide" ||
+        opt == "--reload" || opt == "--stats" || opt == "--metrics") {
+        options.request = opt.substr(2);
+    } else if (opt == "--query" || opt == "--calc" || opt == "--command" || opt == "--key") {
+        options.request = opt.substr(2) + " " + arg;
+    } else if (opt == "--dmenu") {
+        options.dmenu = true;
+    } else if (opt == "--ping") {
+        options.ping_count = arg.empty() ? 100 : std::max(1, atoi(arg.c_str()));
+    } else if (opt == "--profile") {
+        #if FUTURISTIC_LAUNCHER_PROFILE
+            options.profile = true;
+            options.profile_path = arg;
+            options.request = "show";
+        #else
+            std::cerr << "futuristic-launcher: built without profiling (rebuild with make PROFILE=1)" << std::endl;
+            options.exit_status = 2;
+        #endif
+    } else {
+        print_usage();
+        options.exit_status = opt == "--help" || opt == "-h" ? 0 : 2;
+    }
+    return options;
+}
+
+void print_usage() {
+    std::cout << "Usage: futuristic-launcher [COMMAND]\n"
+              << "  --toggle          Show or hide the launcher (default)\n"
+              << "  --show, --hide    Show or hide the launcher\n"
+              << "  --query TEXT      Show with TEXT typed into the search entry\n"
+              << "  --calc [EXPR]     Show in calculator mode\n"
+              << "  --command [CMD]   Show in command mode\n"
+              << "  --key TEXT        Type TEXT (or BackSpace) into the shown launcher\n"
+              << "  --reload          Rescan desktop files\n"
+              << "  --stats           Print daemon statistics\n"
+              << "  --metrics         Print daemon metrics in Prometheus text format\n"
+              << "  --ping [N]        Measure control socket round-trip latency\n"
+              << "  --dmenu           Pick one line of stdin and print it (no daemon needed)\n"
+              << "  --profile [FILE]  Start the daemon recording a Chrome trace, written on exit\n";
+}
+
+std::string control_runtime_path(const char *suffix) {
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    std::string base = (dir && dir[0]) ? std::string(dir) + "/futuristic-launcher"
+                                       : "/tmp/futuristic-launcher-" + std::to_string(getuid());
+    return base + "." + suffix;
+}
+
+int control_acquire_lock() {
+    int fd = open(control_runtime_path("lock").c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) return -1;
+
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int control_connect() {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::string path = control_runtime_path("sock");
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool control_write_all(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += n;
+    }
+    return true;
+}
+
+// Every reply ends with an "ok" or "error ..." line
+static bool reply_complete(const std::string& reply) {
+    if (reply.empty() || reply.back() != '\n') return false;
+
+    std::string body = reply.substr(0, reply.size() - 1);
+    size_t start = body.rfind('\n');
+    std::string last = start == std::string::npos ? body : body.substr(start + 1);
+    return last == "ok" || last.rfind("error", 0) == 0;
+}
+
+bool control_read_reply(int fd, std::string& reply) {
+    reply.clear();
+    char buf[512];
+    while (!reply_complete(reply)) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        reply.append(buf, n);
+    }
+    return true;
+}
+
+std::string control_trace_suffix(int64_t client_start) {
+    return "\t" + std::to_string(client_start) + "," + std::to_string(monotonic_us());
+}
+
+bool control_send(const std::string& request, std::string& reply) {
+    int fd = control_connect();
+    if (fd < 0) return false;
+
+    bool ok = control_write_all(fd, request + "\n") && control_read_reply(fd, reply);
+    close(fd);
+    return ok;
+}
+
+int control_measure_latency(int iterations) {
+    int fd = control_connect();
+    if (fd < 0) {
+        std::cerr << "futuristic-launcher: daemon not running" << std::endl;
+        return 1;
+    }
+
+    std::vector<double> samples;
+    std::string reply;
+    for (int i = 0; i < iterations; i++) {
+        int64_t start = monotonic_us();
+        if (!control_write_all(fd, "ping\n") || !control_read_reply(fd, reply)) break;
+        samples.push_back((monotonic_us() - start) / 1000.0);
+    }
+    close(fd);
+
+    if (samples.empty()) return 1;
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) { return samples[std::min(samples.size() - 1, (size_t)(p / 100.0 * samples.size()))]; };
+    printf("%zu round trips: min %.3f  p50 %.3f  p99 %.3f  max %.3f ms\n",
+           samples.size(), samples.front(), pct(50), pct(99), samples.back());
+    return 0;
+}
+
+bool control_shows_launcher(const std::string& request) {
+    return request == "toggle" || request == "show" || request.rfind("query ", 0) == 0 ||
+           request.rfind("calc ", 0) == 0 || request.rfind("command ", 0) == 0;
+}
+
+int control_forward(const ControlOptions& options, int64_t client_start) {
+    // --dmenu runs standalone and --profile has to start the daemon itself
+    if (options.dmenu || options.profile) return -1;
+
+    std::string reply;
+    if (!control_send(options.request + control_trace_suffix(client_start), reply)) {
+        // Only requests that show the launcher start a daemon; a daemon started
+        // for --reload or --stats would map its window without being "visible"
+        if (control_shows_launcher(options.request)) return -1;
+        std::cerr << "futuristic-launcher: daemon not running" << std::endl;
+        return 1;
+    }
+
+    bool error = reply.rfind("error", 0) == 0;
+    bool report = options.request == "stats" || options.request == "metrics";
+    if (report && reply.size() >= 3) reply.erase(reply.size() - 3);  // trailing "ok"
+    if (report || error) std::cout << reply;
+    return error ? 1 : 0;
+}
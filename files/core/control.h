@@ -0,0 +1,48 @@
+// Control socket client side: command line, lock and request round trip
+#ifndef FUTURISTIC_CORE_CONTROL_H
+#define FUTURISTIC_CORE_CONTROL_H
+
+#include <cstdint>
+#include <string>
+
+// Parsed command line, shared by the futuristic-launcher client and the daemon
+struct ControlOptions {
+    std::string request = "toggle";
+    int ping_count = 0;
+    bool dmenu = false;
+    bool profile = false;
+    std::string profile_path;  // empty: the daemon picks one in the runtime dir
+    int exit_status = -1;      // >= 0 once the command line was fully handled (--help, bad option)
+};
+
+ControlOptions parse_control_options(int argc, char *argv[]);
+void print_usage();
+
+// Plain syscalls only, so the client path never loads GTK, config or catalog.
+// $XDG_RUNTIME_DIR is private to the user, unlike /tmp.
+std::string control_runtime_path(const char *suffix);
+
+// Returns the held lock fd or -1 if a daemon is running
+int control_acquire_lock();
+
+int control_connect();
+bool control_write_all(int fd, const std::string& data);
+bool control_read_reply(int fd, std::string& reply);
+
+// Appended to requests so the daemon can trace the whole show path
+std::string control_trace_suffix(int64_t client_start);
+
+// Returns false if no daemon is listening
+bool control_send(const std::string& request, std::string& reply);
+
+// Round-trip latency of the control socket, measured on one connection
+int control_measure_latency(int iterations);
+
+// toggle, show, query, calc and command; only these may start a daemon
+bool control_shows_launcher(const std::string& request);
+
+// Sends the request to a running daemon and prints what the command returns.
+// Returns the exit status, or -1 when this process has to start the daemon.
+int control_forward(const ControlOptions& options, int64_t client_start);
+
+#endif
@@ -0,0 +1,152 @@
+#include "desktop.h"
+#include "profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+DesktopApp parse_desktop_file(const std::string& filepath) {
+    PROFILE_SCOPE("parse_desktop_file");
+    DesktopApp app;
+    std::ifstream file(filepath);
+    std::string line;
+    bool in_desktop_entry = false;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        
+        if (line == "[Desktop Entry]") {
+            in_desktop_entry = true;
+            continue;
+        } else if (line[0] == '[') {
+            in_desktop_entry = false;
+            continue;
+        }
+
+        if (!in_desktop_entry) continue;
+
+        size_t eq_pos = line.find('=');
+        if (eq_pos == std::string::npos) continue;
+
+        std::string key = line.substr(0, eq_pos);
+        std::string value = line.substr(eq_pos + 1);
+
+        if (key == "Name") {
+            app.name = value;
+        } else if (key == "Exec") {
+            app.exec = value;
+        } else if (key == "Icon") {
+            app.icon = value;
+        } else if (key == "Comment") {
+            app.comment = value;
+        } else if (key == "Categories") {
+            app.categories = value;
+        } else if (key == "NoDisplay" || key == "Hidden") {
+            app.no_display = app.no_display || (value == "true");
+        } else if (key == "Type" && value != "Application") {
+            app.no_display = true;
+        }
+    }
+
+    return app;
+}
+
+std::string desktop_file_id(const fs::path& file, const std::string& dir) {
+    std::string id = file.lexically_relative(dir).string();
+    std::replace(id.begin(), id.end(), '/', '-');
+    return id;
+}
+
+static std::string escape_field(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        switch (c) {
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\\': out += "\\\\"; break;
+            default: out += c; break;
+        }
+    }
+    return out;
+}
+
+static std::string unescape_field(const std::string& value) {
+    std::string out;
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            out += value[i];
+            continue;
+        }
+        char c = value[++i];
+        out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    }
+    return out;
+}
+
+bool write_catalog_snapshot(const std::string& path, const std::vector<DesktopApp>& apps) {
+    std::ofstream file(path);
+    file << "# futuristic-launcher catalog v1\n";
+    for (const auto& app : apps) {
+        file << escape_field(app.id) << '\t' << escape_field(app.name) << '\t'
+             << escape_field(app.comment) << '\t' << escape_field(app.exec) << '\t'
+             << escape_field(app.icon) << '\t' << escape_field(app.categories) << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+std::vector<DesktopApp> read_catalog_snapshot(const std::string& path) {
+    std::vector<DesktopApp> apps;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        
+        std::vector<std::string> fields;
+        for (size_t start = 0; start <= line.size();) {
+            size_t end = std::min(line.find('\t', start), line.size());
+            fields.push_back(unescape_field(line.substr(start, end - start)));
+            start = end + 1;
+        }
+        if (fields.size() != 6) continue;
+        
+        DesktopApp app;
+        app.id = fields[0];
+        app.name = fields[1];
+        app.comment = fields[2];
+        app.exec = fields[3];
+        app.icon = fields[4];
+        app.categories = fields[5];
+        if (DesktopExec::parse(app, app.argv)) {
+            apps.push_back(std::move(app));
+        }
+    }
+    return apps;
+}
+
+std::vector<DesktopApp> scan_desktop_files(const std::vector<std::string>& dirs) {
+    std::set<std::string> seen_ids;
+    std::vector<DesktopApp> apps;
+    
+    for (const auto& dir : dirs) {
+        std::error_code ec;
+        auto options = fs::directory_options::skip_permission_denied;
+        for (fs::recursive_directory_iterator it(dir, options, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != ".desktop") continue;
+            
+            std::string id = desktop_file_id(it->path(), dir);
+            if (!seen_ids.insert(id).second) continue;
+            
+            DesktopApp app = parse_desktop_file(it->path().string());
+            if (app.name.empty() || app.no_display) continue;
+            app.id = id;
+            app.path = it->path().string();
+            if (!DesktopExec::parse(app, app.argv)) {
+                std::cerr << "Ignoring " << app.path << ": invalid Exec" << std::endl;
+                continue;
+            }
+            apps.push_back(std::move(app));
+        }
+    }
+    return apps;
+}
@@ -0,0 +1,146 @@
+// .desktop file parsing: one entry per file, Exec split into argv
+#ifndef FUTURISTIC_CORE_DESKTOP_H
+#define FUTURISTIC_CORE_DESKTOP_H
+
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// One parsed .desktop file; only used while loading, the resident copy is AppCatalog
+struct DesktopApp {
+    std::string id;  // desktop-file ID, e.g. "org.gnome.Nautilus.desktop"
+    std::string path;
+    std::string name;
+    std::string exec;
+    std::vector<std::string> argv;  // Exec with field codes expanded
+    std::string icon;
+    std::string comment;
+    std::string categories;
+    bool no_display = false;
+    int launch_count = 0;
+    time_t last_launch = 0;
+    double frecency = 0.0;
+    bool is_favorite = false;
+};
+
+// Exec key parsing per the Desktop Entry spec. The launcher never passes
+// files or URLs, so %f %u %F %U expand to nothing.
+struct DesktopExec {
+    // String-value escapes (\s \n \t \r \\) are undone before quoting rules apply
+    static std::string unescape_value(std::string_view value) {
+        std::string out;
+        out.reserve(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+            if (value[i] != '\\' || i + 1 == value.size()) {
+                out += value[i];
+                continue;
+            }
+            switch (value[++i]) {
+                case 's': out += ' '; break;
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case '\\': out += '\\'; break;
+                default: out += '\\'; out += value[i]; break;
+            }
+        }
+        return out;
+    }
+    
+    // False for unterminated quotes, unknown field codes or an empty command
+    static bool parse(const DesktopApp& app, std::vector<std::string>& argv) {
+        std::string exec = unescape_value(app.exec);
+        std::string arg;
+        bool in_arg = false;
+        bool quoted = false;
+        argv.clear();
+        
+        for (size_t i = 0; i < exec.size(); i++) {
+            char c = exec[i];
+            
+            if (quoted) {
+                if (c == '"') {
+                    quoted = false;
+                } else if (c == '\\' && i + 1 < exec.size() && strchr("\"`$\\", exec[i + 1])) {
+                    arg += exec[++i];
+                } else {
+                    arg += c;
+                }
+                continue;
+            }
+            
+            if (c == ' ' || c == '\t') {
+                if (in_arg) {
+                    argv.push_back(arg);
+                    arg.clear();
+                    in_arg = false;
+                }
+            } else if (c == '"') {
+                quoted = true;
+                in_arg = true;
+            } else if (c == '%') {
+                if (i + 1 == exec.size()) return false;
+                switch (exec[++i]) {
+                    case '%':
+                        arg += '%';
+                        in_arg = true;
+                        break;
+                    case 'i':
+                        // Expands to two arguments of its own, so it ends any word it touches
+                        if (in_arg) {
+                            argv.push_back(arg);
+                            arg.clear();
+                            in_arg = false;
+                        }
+                        if (!app.icon.empty()) {
+                            argv.push_back("--icon");
+                            argv.push_back(app.icon);
+                        }
+                        break;
+                    case 'c':
+                        arg += app.name;
+                        in_arg = true;
+                        break;
+                    case 'k':
+                        arg += app.path;
+                        in_arg = true;
+                        break;
+                    // No files or URLs; %d %D %n %N %v %m are deprecated
+                    case 'f': case 'F': case 'u': case 'U':
+                    case 'd': case 'D': case 'n': case 'N': case 'v': case 'm':
+                        break;
+                    default:
+                        return false;
+                }
+            } else {
+                arg += c;
+                in_arg = true;
+            }
+        }
+        
+        if (quoted) return false;
+        if (in_arg) argv.push_back(arg);
+        return !argv.empty();
+    }
+};
+
+DesktopApp parse_desktop_file(const std::string& filepath);
+
+// Path below the applications directory with '/' replaced by '-'
+std::string desktop_file_id(const fs::path& file, const std::string& dir);
+
+// Tab-separated id, name, comment, exec, icon, categories; one app per line.
+// Lets replay tools run against a frozen catalog instead of the installed apps.
+bool write_catalog_snapshot(const std::string& path, const std::vector<DesktopApp>& apps);
+std::vector<DesktopApp> read_catalog_snapshot(const std::string& path);
+
+// Visible apps with a valid Exec, in directory order. The first file seen for
+// an ID wins, even if it hides the app, so earlier directories shadow later ones.
+std::vector<DesktopApp> scan_desktop_files(const std::vector<std::string>& dirs);
+
+#endif
@@ -0,0 +1,161 @@
+#include "dmenu.h"
+#include "search.h"
+#include "profile.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+void LineStore::add_bytes(const char *data, size_t size) {
+    if (full || truncating || size == 0) return;
+    
+    size_t pending = chunks.empty() ? 0 : used - line_start;
+    if (pending + size > MAX_LINE) {
+        size = MAX_LINE - pending;
+        truncating = true;
+    }
+    
+    if (chunks.empty() || used + size > CHUNK_BYTES) {
+        if ((chunks.size() + 1) * CHUNK_BYTES + lines.capacity() * sizeof(uint64_t) > max_bytes) {
+            full = true;
+            return;
+        }
+        // The incomplete line moves to the new chunk so every line is contiguous
+        auto chunk = std::make_unique<char[]>(CHUNK_BYTES);
+        if (pending > 0) {
+            memcpy(chunk.get(), chunks.back().get() + line_start, pending);
+        }
+        chunks.push_back(std::move(chunk));
+        used = pending;
+        line_start = 0;
+    }
+    
+    memcpy(chunks.back().get() + used, data, size);
+    used += size;
+}
+
+void LineStore::end_line() {
+    if (full) {
+        dropped++;
+    } else if (!chunks.empty() && used > line_start) {
+        lines.push_back(static_cast<uint64_t>(chunks.size() - 1) << 40 |
+                        static_cast<uint64_t>(line_start) << 20 | (used - line_start));
+    }
+    line_start = used;
+    truncating = false;
+}
+
+void LineStore::append(const char *data, size_t size) {
+    while (size > 0) {
+        const char *newline = static_cast<const char*>(memchr(data, '\n', size));
+        if (!newline) {
+            add_bytes(data, size);
+            return;
+        }
+        size_t length = newline - data;
+        add_bytes(data, length);
+        end_line();
+        data += length + 1;
+        size -= length + 1;
+    }
+}
+
+void LineStore::finish() {
+    if (!chunks.empty() && used > line_start) end_line();
+}
+
+void DmenuFilter::set_query(const std::string& text) {
+    if (text == query) return;
+    
+    // Appending to the query can only drop matches, so a complete result set
+    // that never overflowed the heap just needs rescoring
+    bool narrowing = !query.empty() && text.size() > query.size() &&
+                     text.compare(0, query.size(), query) == 0 && done() && heap.size() < limit;
+    query = text;
+    changes++;
+    
+    if (narrowing) {
+        for (Hit& hit : heap) {
+            hit.score = fuzzy_score(lines.line(hit.index), query);
+        }
+        heap.erase(std::remove_if(heap.begin(), heap.end(), [](const Hit& hit) { return hit.score <= 0; }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), better);
+        return;
+    }
+    
+    heap.clear();
+    scanned = 0;
+}
+
+bool DmenuFilter::advance(size_t count) {
+    size_t end = std::min(lines.size(), scanned + count);
+    if (query.empty()) {
+        if (std::min(scanned, limit) != std::min(end, limit)) changes++;
+        scanned = end;
+        return done();
+    }
+    
+    PROFILE_SCOPE_NAMED(scoring, "DmenuFilter::advance", "lines");
+    PROFILE_ARG(scoring, static_cast<int64_t>(end - scanned));
+    if (!pool || pool->size() == 1 || end - scanned < PARALLEL_MIN_LINES) {
+        if (score_range(heap, scanned, end)) changes++;
+        scanned = end;
+        return done();
+    }
+    
+    // The overall top `limit` is within the union of every worker's top `limit`
+    worker_heaps.resize(pool->size());
+    for (WorkerHeap& worker : worker_heaps) {
+        worker.hits.clear();
+    }
+    size_t first = scanned;
+    pool->parallel_for(end - first, PARALLEL_CHUNK_LINES, [&](size_t begin, size_t stop, unsigned worker) {
+        score_range(worker_heaps[worker].hits, first + begin, first + stop);
+    });
+    
+    bool kept = false;
+    for (const WorkerHeap& worker : worker_heaps) {
+        for (const Hit& hit : worker.hits) {
+            kept |= offer(heap, hit);
+        }
+    }
+    if (kept) changes++;
+    scanned = end;
+    return done();
+}
+
+bool DmenuFilter::offer(std::vector<Hit>& top, Hit hit) const {
+    if (top.size() < limit) {
+        top.push_back(hit);
+        std::push_heap(top.begin(), top.end(), better);
+        return true;
+    }
+    if (!better(hit, top.front())) return false;
+    
+    std::pop_heap(top.begin(), top.end(), better);
+    top.back() = hit;
+    std::push_heap(top.begin(), top.end(), better);
+    return true;
+}
+
+bool DmenuFilter::score_range(std::vector<Hit>& top, size_t begin, size_t end) const {
+    bool kept = false;
+    for (size_t i = begin; i < end; i++) {
+        int score = fuzzy_score(lines.line(i), query);
+        if (score > 0) kept |= offer(top, Hit{score, static_cast<uint32_t>(i)});
+    }
+    return kept;
+}
+
+void DmenuFilter::results(std::vector<uint32_t>& out) const {
+    out.clear();
+    if (query.empty()) {
+        for (uint32_t i = 0; i < std::min(scanned, limit); i++) out.push_back(i);
+        return;
+    }
+    
+    std::vector<Hit> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), better);
+    for (const Hit& hit : sorted) out.push_back(hit.index);
+}
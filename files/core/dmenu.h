@@ -0,0 +1,106 @@
+// --dmenu input: newline-separated items streamed from stdin, filtered while they arrive
+#ifndef FUTURISTIC_CORE_DMENU_H
+#define FUTURISTIC_CORE_DMENU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+// Items packed into fixed 1 MiB chunks, so ingesting never copies what is already
+// stored; each line costs its bytes plus one 8-byte entry. Once max_bytes is
+// reached further lines are counted but not kept.
+class LineStore {
+public:
+    static constexpr size_t CHUNK_BYTES = 1 << 20;
+    static constexpr size_t MAX_LINE = CHUNK_BYTES - 1;  // longer lines are truncated
+    
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<uint64_t> lines;  // chunk << 40 | offset << 20 | length
+    size_t used = 0;              // bytes used in the last chunk
+    size_t line_start = 0;        // offset of the incomplete line in the last chunk
+    bool truncating = false;
+    bool full = false;
+    uint64_t dropped = 0;
+    size_t max_bytes;
+    
+    void add_bytes(const char *data, size_t size);
+    void end_line();
+    
+public:
+    explicit LineStore(size_t max_bytes = 256u << 20) : max_bytes(max_bytes) {}
+    
+    // Raw input in any chunking; empty lines are skipped
+    void append(const char *data, size_t size);
+    // End of input: a last line without a newline still counts
+    void finish();
+    
+    size_t size() const { return lines.size(); }
+    std::string_view line(size_t index) const {
+        uint64_t entry = lines[index];
+        return std::string_view(chunks[entry >> 40].get() + ((entry >> 20) & MAX_LINE), entry & MAX_LINE);
+    }
+    uint64_t dropped_lines() const { return dropped; }
+    size_t memory_bytes() const { return chunks.size() * CHUNK_BYTES + lines.capacity() * sizeof(uint64_t); }
+};
+
+// Best `limit` lines for the current query, kept in a bounded heap and extended
+// incrementally: advance() scores lines that have not been scored yet, whether the
+// query just changed or new input arrived. An empty query lists lines in input order.
+// With a pool, large batches are split across it: each worker fills its own bounded
+// heap and those are merged, which gives the same results as one thread.
+class DmenuFilter {
+public:
+    // Below this many lines per advance(), waking the pool costs more than it saves
+    static constexpr size_t PARALLEL_MIN_LINES = 16384;
+    static constexpr size_t PARALLEL_CHUNK_LINES = 2048;
+    
+private:
+    struct Hit {
+        int score;
+        uint32_t index;
+    };
+    
+    // Padded so workers growing their heaps do not share a cache line
+    struct alignas(64) WorkerHeap {
+        std::vector<Hit> hits;
+    };
+    
+    const LineStore& lines;
+    size_t limit;
+    ThreadPool *pool;
+    std::vector<WorkerHeap> worker_heaps;
+    std::string query;
+    size_t scanned = 0;
+    std::vector<Hit> heap;  // worst hit at the front
+    uint64_t changes = 0;
+    
+    // Higher score first, then input order
+    static bool better(const Hit& a, const Hit& b) {
+        return a.score != b.score ? a.score > b.score : a.index < b.index;
+    }
+    
+    // Bounded insert; false if the hit did not make the top `limit`
+    bool offer(std::vector<Hit>& top, Hit hit) const;
+    // Scores [begin, end) into `top`; true if any line was kept
+    bool score_range(std::vector<Hit>& top, size_t begin, size_t end) const;
+    
+public:
+    DmenuFilter(const LineStore& store, size_t max_results, ThreadPool *workers = nullptr)
+        : lines(store), limit(max_results), pool(workers) {}
+    
+    void set_query(const std::string& text);
+    // Scores up to `count` more lines; true once every stored line has been scored
+    bool advance(size_t count);
+    bool done() const { return scanned >= lines.size(); }
+    // Changes whenever results() would return something different
+    uint64_t version() const { return changes; }
+    void results(std::vector<uint32_t>& out) const;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "keystrokes.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static std::string sanitize(const std::string& text) {
+    if (!text.empty() && (text[0] == '?' || text[0] == '>')) {
+        return text.substr(0, 1);
+    }
+    std::string out = text;
+    for (char& c : out) {
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    }
+    return out;
+}
+
+void KeystrokeRecorder::begin(int64_t now_us) {
+    finish();
+    shown_us = now_us;
+    active = true;
+    buffer = "S\t" + std::to_string(time(NULL)) + "\n";
+}
+
+void KeystrokeRecorder::query(int64_t now_us, const std::string& text) {
+    if (!active) return;
+    buffer += "Q\t" + std::to_string(elapsed_ms(now_us)) + "\t" + sanitize(text) + "\n";
+}
+
+void KeystrokeRecorder::launch(int64_t now_us, const std::string& id) {
+    if (!active) return;
+    buffer += "L\t" + std::to_string(elapsed_ms(now_us)) + "\t" + sanitize(id) + "\n";
+    finish();
+}
+
+void KeystrokeRecorder::dismiss(int64_t now_us) {
+    if (!active) return;
+    buffer += "E\t" + std::to_string(elapsed_ms(now_us)) + "\n";
+    finish();
+}
+
+void KeystrokeRecorder::finish() {
+    if (!active) return;
+    active = false;
+
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (fd < 0 || write(fd, buffer.data(), buffer.size()) < 0) {
+        std::cerr << "Failed to append to " << path << std::endl;
+    }
+    if (fd >= 0) close(fd);
+    buffer.clear();
+}
+
+std::vector<KeystrokeSession> read_keystroke_log(const std::string& path) {
+    std::vector<KeystrokeSession> sessions;
+    std::ifstream file(path);
+    std::string line;
+    bool open_session = false;
+
+    auto close_session = [&]() {
+        if (open_session && sessions.back().queries.empty()) sessions.pop_back();
+        open_session = false;
+    };
+
+    while (std::getline(file, line)) {
+        if (line.size() < 2 || line[1] != '\t') continue;
+        std::string rest = line.substr(2);
+        std::string field = rest.substr(0, rest.find('\t'));
+        std::string text = rest.find('\t') == std::string::npos ? "" : rest.substr(rest.find('\t') + 1);
+        int64_t value = strtoll(field.c_str(), NULL, 10);
+
+        if (line[0] == 'S') {
+            close_session();
+            sessions.emplace_back();
+            sessions.back().started = static_cast<time_t>(value);
+            open_session = true;
+        } else if (!open_session) {
+            continue;
+        } else if (line[0] == 'Q') {
+            sessions.back().queries.emplace_back(value, text);
+        } else if (line[0] == 'L' || line[0] == 'E') {
+            sessions.back().launched_id = line[0] == 'L' ? text : "";
+            sessions.back().ended_ms = value;
+            close_session();
+        }
+    }
+    close_session();
+    return sessions;
+}
@@ -0,0 +1,48 @@
+// Recorded search sessions: what was typed between show and launch or hide
+#ifndef FUTURISTIC_CORE_KEYSTROKES_H
+#define FUTURISTIC_CORE_KEYSTROKES_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One line per event, tab-separated, times in ms since the launcher was shown:
+//   S <unix time>      session start
+//   Q <ms> <query>     search entry changed
+//   L <ms> <app id>    app launched, ends the session
+//   E <ms>             hidden without a launch
+struct KeystrokeSession {
+    time_t started = 0;
+    std::vector<std::pair<int64_t, std::string>> queries;
+    std::string launched_id;  // empty when dismissed
+    int64_t ended_ms = 0;
+};
+
+// Buffers the current session and appends it with a single write when it ends,
+// so typing never waits on the disk. Web and command queries are reduced to
+// their prefix character.
+class KeystrokeRecorder {
+    std::string path;
+    std::string buffer;
+    int64_t shown_us = 0;
+    bool active = false;
+
+    int64_t elapsed_ms(int64_t now_us) const { return (now_us - shown_us) / 1000; }
+    void finish();
+
+public:
+    explicit KeystrokeRecorder(std::string log_path) : path(std::move(log_path)) {}
+    ~KeystrokeRecorder() { finish(); }
+
+    void begin(int64_t now_us);
+    void query(int64_t now_us, const std::string& text);
+    void launch(int64_t now_us, const std::string& id);
+    void dismiss(int64_t now_us);
+};
+
+// Sessions without a start line or a query are skipped
+std::vector<KeystrokeSession> read_keystroke_log(const std::string& path);
+
+#endif
@@ -0,0 +1,104 @@
+// Daemon metrics: lock-free counters and histograms plus Prometheus text output
+#ifndef FUTURISTIC_CORE_METRICS_H
+#define FUTURISTIC_CORE_METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// Relaxed atomics throughout: any thread may update, readers get a recent value
+struct MetricCounter {
+    std::atomic<uint64_t> value{0};
+    
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Log2-bucketed latency histogram in microseconds
+struct LatencyHistogram {
+    static constexpr int BUCKETS = 32;
+    std::atomic<uint64_t> counts[BUCKETS] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum_us{0};
+    
+    // Bucket i holds values below 2^i us
+    void add(int64_t us) {
+        int bucket = us <= 0 ? 0 : 64 - __builtin_clzll(static_cast<unsigned long long>(us));
+        counts[std::min(bucket, BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+        sum_us.fetch_add(us > 0 ? us : 0, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    
+    // Upper bound of the bucket holding the p-th percentile
+    int64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return i == 0 ? 0 : (1LL << i);
+        }
+        return 1LL << (BUCKETS - 1);
+    }
+};
+
+// Text exposition format 0.0.4, as read by node_exporter's textfile collector
+class PrometheusText {
+    std::ostringstream out;
+    std::string prefix;
+    
+    // %.15g keeps byte counts exact where the default stream precision would not
+    static std::string number(double value) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.15g", value);
+        return buf;
+    }
+    
+    void header(const std::string& name, const char *help, const char *type) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " " << type << "\n";
+    }
+    
+public:
+    explicit PrometheusText(std::string name_prefix) : prefix(std::move(name_prefix)) {}
+    
+    void counter(const char *name, const char *help, uint64_t value) {
+        std::string full = prefix + name;
+        header(full, help, "counter");
+        out << full << " " << value << "\n";
+    }
+    
+    void gauge(const char *name, const char *help, double value) {
+        std::string full = prefix + name;
+        header(full, help, "gauge");
+        out << full << " " << number(value) << "\n";
+    }
+    
+    // Exported in seconds. Buckets are read one at a time while other threads may
+    // add, so +Inf and _count take whichever of bucket sum and total is larger.
+    void histogram(const char *name, const char *help, const LatencyHistogram& hist) {
+        std::string full = prefix + name;
+        header(full, help, "histogram");
+        
+        uint64_t cumulative = 0;
+        for (int i = 0; i < LatencyHistogram::BUCKETS - 1; i++) {
+            cumulative += hist.counts[i].load(std::memory_order_relaxed);
+            out << full << "_bucket{le=\"" << number((1LL << i) / 1e6) << "\"} " << cumulative << "\n";
+        }
+        cumulative += hist.counts[LatencyHistogram::BUCKETS - 1].load(std::memory_order_relaxed);
+        out << full << "_bucket{le=\"+Inf\"} " << std::max(cumulative, hist.count()) << "\n"
+            << full << "_sum " << number(hist.sum_us.load(std::memory_order_relaxed) / 1e6) << "\n"
+            << full << "_count " << std::max(cumulative, hist.count()) << "\n";
+    }
+    
+    std::string str() const { return out.str(); }
+};
+
+#endif
@@ -0,0 +1,170 @@
+// Scoped timers for --profile, shared by the launcher and the core library
+#ifndef FUTURISTIC_CORE_PROFILE_H
+#define FUTURISTIC_CORE_PROFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// CLOCK_MONOTONIC in microseconds, the clock g_get_monotonic_time() reads
+inline int64_t monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// --profile: scoped timers recorded as Chrome trace events. Every thread appends
+// to its own ring buffer; the rings are only read once, after the workers have
+// been joined. Built with FUTURISTIC_LAUNCHER_PROFILE=0 the macros expand to nothing.
+#ifndef FUTURISTIC_LAUNCHER_PROFILE
+    #define FUTURISTIC_LAUNCHER_PROFILE 0
+#endif
+
+#if FUTURISTIC_LAUNCHER_PROFILE
+class Profiler {
+public:
+    struct Event {
+        const char *name;
+        const char *arg_name;  // optional
+        int64_t arg;
+        int64_t start_us;
+        int64_t duration_us;
+    };
+    
+    static constexpr size_t RING_EVENTS = 1 << 15;
+
+private:
+    struct ThreadRing {
+        std::vector<Event> events = std::vector<Event>(RING_EVENTS);
+        uint64_t written = 0;
+        pid_t tid = 0;
+        std::string name;
+    };
+    
+    std::atomic<bool> active{false};
+    std::mutex mutex;  // guards the ring list, not the rings
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    
+    ThreadRing& thread_ring() {
+        thread_local ThreadRing *ring = nullptr;
+        if (!ring) {
+            auto created = std::make_unique<ThreadRing>();
+            created->tid = static_cast<pid_t>(syscall(SYS_gettid));
+            char name[16] = {0};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            created->name = created->tid == getpid() ? "main" : name;
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(std::move(created));
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+    
+    static void write_escaped(std::ostream& out, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out << c;
+        }
+    }
+
+public:
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+    
+    bool enabled() const {
+        return active.load(std::memory_order_relaxed);
+    }
+    
+    void enable() {
+        active.store(true, std::memory_order_relaxed);
+    }
+    
+    void record(const char *name, int64_t start_us, int64_t end_us, const char *arg_name, int64_t arg) {
+        ThreadRing& ring = thread_ring();
+        ring.events[ring.written % RING_EVENTS] = {name, arg_name, arg, start_us, end_us - start_us};
+        ring.written++;
+    }
+    
+    // Call once every instrumented thread has stopped
+    bool write(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+        
+        pid_t pid = getpid();
+        uint64_t total = 0;
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"tid\":" << pid << ",\"args\":{\"name\":\"futuristic-launcher\"}}";
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& ring : rings) {
+            uint64_t dropped = ring->written > RING_EVENTS ? ring->written - RING_EVENTS : 0;
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << ring->tid
+                << ",\"args\":{\"name\":\"";
+            write_escaped(out, ring->name);
+            out << "\",\"dropped_events\":" << dropped << "}}";
+            
+            for (uint64_t i = dropped; i < ring->written; i++) {
+                const Event& event = ring->events[i % RING_EVENTS];
+                out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"launcher\",\"ph\":\"X\",\"pid\":" << pid
+                    << ",\"tid\":" << ring->tid << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us;
+                if (event.arg_name) {
+                    out << ",\"args\":{\"" << event.arg_name << "\":" << event.arg << "}";
+                }
+                out << "}";
+            }
+            total += ring->written - dropped;
+        }
+        out << "\n]}\n";
+        std::cerr << "futuristic-launcher: wrote " << total << " trace events to " << path << std::endl;
+        return static_cast<bool>(out);
+    }
+};
+
+class ProfileScope {
+private:
+    const char *name;
+    const char *arg_name;
+    int64_t arg = 0;
+    int64_t start_us;
+
+public:
+    explicit ProfileScope(const char *name, const char *arg_name = nullptr)
+        : name(name), arg_name(arg_name),
+          start_us(Profiler::instance().enabled() ? monotonic_us() : 0) {}
+    
+    ~ProfileScope() {
+        if (start_us != 0) {
+            Profiler::instance().record(name, start_us, monotonic_us(), arg_name, arg);
+        }
+    }
+    
+    void set_arg(int64_t value) {
+        arg = value;
+    }
+};
+
+    #define PROFILE_JOIN_INNER(a, b) a##b
+    #define PROFILE_JOIN(a, b) PROFILE_JOIN_INNER(a, b)
+    #define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profile_scope_, __LINE__)(name)
+    #define PROFILE_SCOPE_NAMED(var, name, arg_name) ProfileScope var(name, arg_name)
+    #define PROFILE_ARG(var, value) var.set_arg(value)
+#else
+    #define PROFILE_SCOPE(name) do {} while (0)
+    #define PROFILE_SCOPE_NAMED(var, name, arg_name) do {} while (0)
+    #define PROFILE_ARG(var, value) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+#include "search.h"
+#include "profile.h"
+
+#include <cstdio>
+#include <regex>
+
+void build_catalog(std::vector<DesktopApp>& apps, const UsageJournal& usage,
+                   const std::set<std::string>& favorites, AppCatalog& catalog, AppIndex& index) {
+    for (DesktopApp& app : apps) {
+        if (const UsageJournal::AppUsage *stats = usage.usage(app.id)) {
+            app.launch_count = stats->count;
+            app.last_launch = stats->last;
+            app.frecency = stats->frecency;
+        }
+        app.is_favorite = favorites.count(app.id) > 0;
+    }
+    
+    std::sort(apps.begin(), apps.end(), 
+        [](const DesktopApp& a, const DesktopApp& b) {
+            if (a.is_favorite != b.is_favorite) return a.is_favorite;
+            if (a.frecency != b.frecency) return a.frecency > b.frecency;
+            if (a.name != b.name) return a.name < b.name;
+            return a.id < b.id;
+        });
+    
+    catalog.reserve(apps.size());
+    for (const auto& app : apps) {
+        catalog.add(app);
+    }
+    catalog.shrink_to_fit();
+    index.build(catalog);
+}
+
+QueryMode search(const AppCatalog& catalog, const AppIndex& index, const UsageJournal& usage,
+                 const std::string& query, std::vector<uint32_t>& out) {
+    out.clear();
+    
+    if (query.empty()) {
+        for (uint32_t slot = 0; slot < catalog.size(); slot++) {
+            out.push_back(slot);
+        }
+        return QUERY_APPS;
+    }
+    
+    if (query[0] == '?') {
+        return QUERY_WEB;
+    } else if (query[0] == '>') {
+        return QUERY_COMMAND;
+    }
+    
+    static const std::regex math_regex(R"(^[\d\s\+\-\*\/\(\)\.]+$)");
+    if (std::regex_match(query, math_regex) && !std::isnan(calculate_expression(query))) {
+        return QUERY_CALCULATOR;
+    }
+    
+    rank_apps(catalog, index, usage, query, out);
+    return QUERY_APPS;
+}
+
+void rank_apps(const AppCatalog& catalog, const AppIndex& index, const UsageJournal& usage,
+               const std::string& query, std::vector<uint32_t>& out) {
+    out.clear();
+    
+    // Few apps have history for a given query; spread it over slots once
+    std::vector<double> affinity(catalog.size(), 0.0);
+    if (const UsageJournal::AffinityMap *weights = usage.affinities_for(query)) {
+        for (const auto& [id, weight] : *weights) {
+            int slot = index.find(id);
+            if (slot >= 0) affinity[slot] = weight;
+        }
+    }
+    
+    // One aggregate event: fuzzy_score itself is too hot for a scope per call
+    std::vector<std::pair<uint32_t, int>> scored_apps;
+    {
+        PROFILE_SCOPE_NAMED(scoring, "fuzzy_score", "calls");
+        PROFILE_ARG(scoring, 2 * static_cast<int64_t>(catalog.size()));
+        for (uint32_t slot = 0; slot < catalog.size(); slot++) {
+            int name_score = fuzzy_score(catalog.name(slot), query);
+            int comment_score = fuzzy_score(catalog.comment(slot), query) / 2;
+            int total_score = name_score + comment_score;
+            
+            if (total_score > 0) {
+                scored_apps.push_back({slot, total_score + rank_bonus(catalog.frecency[slot], affinity[slot])});
+            }
+        }
+    }
+    
+    std::sort(scored_apps.begin(), scored_apps.end(),
+        [](const auto& a, const auto& b) {
+            return a.second > b.second;
+        });
+    
+    out.reserve(scored_apps.size());
+    for (const auto& [slot, score] : scored_apps) {
+        out.push_back(slot);
+    }
+}
+
+double calculate_expression(const std::string& expr) {
+    try {
+        std::string clean_expr = expr;
+        clean_expr.erase(std::remove(clean_expr.begin(), clean_expr.end(), ' '), clean_expr.end());
+        
+        std::string cmd = "echo '" + clean_expr + "' | bc -l 2>/dev/null";
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) return NAN;
+        
+        char buffer[128];
+        std::string result;
+        while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
+            result += buffer;
+        }
+        pclose(pipe);
+        
+        if (result.empty()) return NAN;
+        return std::stod(result);
+        
+    } catch (...) {
+        return NAN;
+    }
+}
@@ -0,0 +1,83 @@
+// Matching and ranking of the catalog against a query, and the calculator
+#ifndef FUTURISTIC_CORE_SEARCH_H
+#define FUTURISTIC_CORE_SEARCH_H
+
+#include "catalog.h"
+#include "usage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Case-insensitive without copying either string; runs for every app per keystroke
+inline int fuzzy_score(std::string_view str, std::string_view pattern) {
+    // ASCII folding; bytes of UTF-8 sequences compare exactly, as tolower() left them
+    auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c; };
+    auto same = [&](char a, char b) { return lower(a) == lower(b); };
+    
+    int score = 0;
+    size_t str_idx = 0;
+    size_t pat_idx = 0;
+    size_t consecutive = 0;
+    
+    while (str_idx < str.length() && pat_idx < pattern.length()) {
+        if (same(str[str_idx], pattern[pat_idx])) {
+            score += 1 + consecutive * 5;
+            consecutive++;
+            pat_idx++;
+        } else {
+            consecutive = 0;
+        }
+        str_idx++;
+    }
+    
+    if (pat_idx != pattern.length()) {
+        return 0;
+    }
+    
+    auto match = std::search(str.begin(), str.end(), pattern.begin(), pattern.end(), same);
+    if (match != str.end() || pattern.empty()) {
+        score += 50;
+    }
+    
+    if (match == str.begin()) {
+        score += 100;
+    }
+    
+    return score;
+}
+
+// Frecency plus how often this query led to this app
+inline int rank_bonus(double frecency, double affinity) {
+    return static_cast<int>(10.0 * std::log1p(frecency) + 60.0 * std::min(affinity, 3.0));
+}
+
+// What the search entry text selects; only QUERY_APPS fills the result list
+enum QueryMode {
+    QUERY_APPS,
+    QUERY_WEB,         // "?terms"
+    QUERY_COMMAND,     // ">command"
+    QUERY_CALCULATOR   // arithmetic that bc evaluates
+};
+
+// Fills usage and favorite state, then adds favorites first, by frecency, then
+// by name to an empty catalog and indexes it. Slot order is the empty-query list.
+void build_catalog(std::vector<DesktopApp>& apps, const UsageJournal& usage,
+                   const std::set<std::string>& favorites, AppCatalog& catalog, AppIndex& index);
+
+// Everything a keystroke does before widgets are touched: mode detection, then ranking
+QueryMode search(const AppCatalog& catalog, const AppIndex& index, const UsageJournal& usage,
+                 const std::string& query, std::vector<uint32_t>& out);
+
+// Catalog slots that match query, best first
+void rank_apps(const AppCatalog& catalog, const AppIndex& index, const UsageJournal& usage,
+               const std::string& query, std::vector<uint32_t>& out);
+
+// Evaluated by bc(1); NAN if it is not an expression
+double calculate_expression(const std::string& expr);
+
+#endif
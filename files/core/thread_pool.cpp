@@ -0,0 +1,106 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+static uint64_t pack(uint64_t front, uint64_t back) {
+    return front << 32 | back;
+}
+
+ThreadPool::ThreadPool(unsigned thread_count) {
+    workers = thread_count > 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    shares = std::make_unique<Share[]>(workers);
+    for (unsigned worker = 1; worker < workers; worker++) {
+        threads.emplace_back(&ThreadPool::run, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+bool ThreadPool::take_own(unsigned worker, size_t& chunk) {
+    std::atomic<uint64_t>& range = shares[worker].range;
+    uint64_t current = range.load(std::memory_order_relaxed);
+    while ((current >> 32) < (current & 0xffffffff)) {
+        if (range.compare_exchange_weak(current, current + (uint64_t(1) << 32), std::memory_order_relaxed)) {
+            chunk = current >> 32;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal(unsigned worker, size_t& chunk) {
+    for (unsigned offset = 1; offset < workers; offset++) {
+        std::atomic<uint64_t>& range = shares[(worker + offset) % workers].range;
+        uint64_t current = range.load(std::memory_order_relaxed);
+        while ((current >> 32) < (current & 0xffffffff)) {
+            if (range.compare_exchange_weak(current, current - 1, std::memory_order_relaxed)) {
+                chunk = (current & 0xffffffff) - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::work(unsigned worker) {
+    size_t chunk;
+    while (take_own(worker, chunk) || steal(worker, chunk)) {
+        (*body)(chunk * grain, std::min(items, (chunk + 1) * grain), worker);
+    }
+}
+
+void ThreadPool::run(unsigned worker) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        
+        lock.unlock();
+        work(worker);
+        lock.lock();
+        
+        if (--running == 0) finished.notify_one();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, size_t chunk_items, const Body& fn) {
+    if (count == 0) return;
+    chunk_items = std::max<size_t>(chunk_items, 1);
+    size_t chunks = (count + chunk_items - 1) / chunk_items;
+    if (workers == 1 || chunks == 1) {
+        fn(0, count, 0);
+        return;
+    }
+    
+    // Published to the helpers by the mutex below
+    for (unsigned worker = 0; worker < workers; worker++) {
+        shares[worker].range.store(pack(chunks * worker / workers, chunks * (worker + 1) / workers),
+                                   std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        body = &fn;
+        items = count;
+        grain = chunk_items;
+        running = workers - 1;
+        generation++;
+    }
+    wake.notify_all();
+    
+    work(0);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return running == 0; });
+    body = nullptr;
+}
@@ -0,0 +1,63 @@
+// Persistent worker threads for splitting one large scan across cores
+#ifndef FUTURISTIC_CORE_THREAD_POOL_H
+#define FUTURISTIC_CORE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// parallel_for() cuts the items into chunks and deals each worker a contiguous
+// share. A worker takes chunks from the front of its own share and, once that is
+// empty, steals from the back of the others', so uneven chunks still finish
+// together. The calling thread is worker 0. One parallel_for at a time.
+class ThreadPool {
+public:
+    // begin/end are item indices; worker < size() identifies per-worker state
+    using Body = std::function<void(size_t begin, size_t end, unsigned worker)>;
+    
+private:
+    // One worker's chunks [front, back), packed so the owner and thieves race on one CAS
+    struct alignas(64) Share {
+        std::atomic<uint64_t> range{0};
+    };
+    
+    unsigned workers;
+    std::unique_ptr<Share[]> shares;
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    uint64_t generation = 0;  // bumped per parallel_for
+    unsigned running = 0;     // helper threads still in the current one
+    bool stopping = false;
+    const Body *body = nullptr;
+    size_t items = 0;
+    size_t grain = 0;
+    std::vector<std::thread> threads;  // last, so the state above exists before they start
+    
+    bool take_own(unsigned worker, size_t& chunk);
+    bool steal(unsigned worker, size_t& chunk);
+    void work(unsigned worker);
+    void run(unsigned worker);
+    
+public:
+    // 0: one worker per hardware thread
+    explicit ThreadPool(unsigned thread_count = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    unsigned size() const { return workers; }
+    
+    // Calls body over [0, count) in chunks of `chunk_items`; returns when all are done
+    void parallel_for(size_t count, size_t chunk_items, const Body& fn);
+};
+
+#endif
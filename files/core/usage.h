@@ -0,0 +1,398 @@
+// Launch history persistence and frecency/affinity scoring
+#ifndef FUTURISTIC_CORE_USAGE_H
+#define FUTURISTIC_CORE_USAGE_H
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Launch history: append-only binary journal folded into a periodic snapshot.
+// All scores are kept "as of" ref_time and decay exponentially with age.
+class UsageJournal {
+public:
+    struct AppUsage {
+        double frecency = 0.0;
+        int count = 0;
+        time_t last = 0;
+    };
+    
+    using AffinityMap = std::unordered_map<std::string, double>;
+    
+    static constexpr size_t MAX_PREFIX = 16;
+    static constexpr size_t COMPACT_RECORDS = 512;
+    static constexpr double MIN_AFFINITY = 0.05;
+
+private:
+    static constexpr uint32_t JOURNAL_MAGIC = 0x314a4c46;   // "FLJ1"
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x31534c46;  // "FLS1"
+    static constexpr uint8_t RECORD_MAGIC = 0xf1;
+    
+    std::string dir;
+    std::unordered_map<std::string, AppUsage> apps;
+    std::unordered_map<std::string, AffinityMap> affinities;  // query prefix -> app id -> weight
+    uint32_t generation = 0;
+    size_t journal_records = 0;
+    double half_life_s = 14 * 86400.0;
+    time_t ref_time = 0;
+    int journal_fd = -1;
+    bool compacting = false;
+    std::string carried;  // records appended while a snapshot is being written
+    size_t carried_records = 0;
+    
+    // Sequential reader over a file slurped into memory
+    struct Reader {
+        const std::string& data;
+        size_t pos = 0;
+        
+        template <typename T>
+        bool get(T& value) {
+            if (pos + sizeof(T) > data.size()) return false;
+            memcpy(&value, data.data() + pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+        
+        bool get_string(std::string& value, size_t len) {
+            if (pos + len > data.size()) return false;
+            value.assign(data, pos, len);
+            pos += len;
+            return true;
+        }
+    };
+    
+    template <typename T>
+    static void put(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    
+    static std::string read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+    
+    std::string journal_path() const { return dir + "/history.journal"; }
+    
+    double decay(double age_s) const {
+        return age_s <= 0 ? 1.0 : std::exp2(-age_s / half_life_s);
+    }
+    
+    static std::string normalize_prefix(const std::string& query) {
+        std::string prefix = query.substr(0, MAX_PREFIX);
+        std::transform(prefix.begin(), prefix.end(), prefix.begin(), ::tolower);
+        return prefix;
+    }
+    
+    // One launch, weighted by its age relative to ref_time
+    void fold(const std::string& id, const std::string& query, time_t timestamp) {
+        double weight = decay(static_cast<double>(ref_time - timestamp));
+        
+        AppUsage& usage = apps[id];
+        usage.frecency += weight;
+        usage.count++;
+        usage.last = std::max(usage.last, timestamp);
+        
+        std::string prefix = normalize_prefix(query);
+        for (size_t len = 1; len <= prefix.size(); len++) {
+            affinities[prefix.substr(0, len)][id] += weight;
+        }
+    }
+    
+    bool load_snapshot() {
+        std::string data = read_file(snapshot_path());
+        Reader in{data};
+        
+        uint32_t magic = 0;
+        int64_t snapshot_time = 0;
+        uint32_t app_count = 0;
+        if (!in.get(magic) || magic != SNAPSHOT_MAGIC || !in.get(generation) ||
+            !in.get(snapshot_time) || !in.get(app_count)) {
+            generation = 0;
+            return false;
+        }
+        
+        double scale = decay(static_cast<double>(ref_time - snapshot_time));
+        for (uint32_t i = 0; i < app_count; i++) {
+            uint16_t id_len = 0;
+            std::string id;
+            AppUsage usage;
+            int64_t last = 0;
+            if (!in.get(id_len) || !in.get_string(id, id_len) || !in.get(usage.frecency) ||
+                !in.get(usage.count) || !in.get(last)) {
+                return false;
+            }
+            usage.frecency *= scale;
+            usage.last = last;
+            apps[id] = usage;
+        }
+        
+        uint32_t affinity_count = 0;
+        if (!in.get(affinity_count)) return false;
+        for (uint32_t i = 0; i < affinity_count; i++) {
+            uint8_t prefix_len = 0;
+            uint16_t id_len = 0;
+            std::string prefix, id;
+            double weight = 0;
+            if (!in.get(prefix_len) || !in.get_string(prefix, prefix_len) ||
+                !in.get(id_len) || !in.get_string(id, id_len) || !in.get(weight)) {
+                return false;
+            }
+            affinities[prefix][id] = weight * scale;
+        }
+        return true;
+    }
+    
+    // Records from an older generation were already folded into the snapshot;
+    // false when the journal does not belong to the current one
+    bool load_journal() {
+        std::string data = read_file(journal_path());
+        Reader in{data};
+        
+        uint32_t magic = 0;
+        uint32_t journal_generation = 0;
+        if (!in.get(magic) || magic != JOURNAL_MAGIC || !in.get(journal_generation) ||
+            journal_generation != generation) {
+            return false;
+        }
+        
+        while (true) {
+            uint8_t record_magic = 0;
+            uint8_t prefix_len = 0;
+            uint16_t id_len = 0;
+            int64_t timestamp = 0;
+            std::string id, prefix;
+            
+            // A torn tail write just ends the journal early
+            if (!in.get(record_magic) || record_magic != RECORD_MAGIC || !in.get(prefix_len) ||
+                !in.get(id_len) || !in.get(timestamp) || !in.get_string(id, id_len) ||
+                !in.get_string(prefix, prefix_len)) {
+                break;
+            }
+            fold(id, prefix, static_cast<time_t>(timestamp));
+            journal_records++;
+        }
+        return true;
+    }
+    
+    bool open_journal(bool truncate) {
+        if (journal_fd >= 0) close(journal_fd);
+        
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        
+        int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+        journal_fd = open(journal_path().c_str(), flags, 0600);
+        if (journal_fd < 0) return false;
+        
+        if (lseek(journal_fd, 0, SEEK_END) == 0) {
+            std::string header;
+            put(header, JOURNAL_MAGIC);
+            put(header, generation);
+            if (write(journal_fd, header.data(), header.size()) < 0) return false;
+        }
+        return true;
+    }
+
+public:
+    ~UsageJournal() {
+        if (journal_fd >= 0) close(journal_fd);
+    }
+    
+    std::string snapshot_path() const { return dir + "/history.snapshot"; }
+    
+    void set_half_life_days(int days) {
+        half_life_s = std::max(1, days) * 86400.0;
+    }
+    
+    // Snapshot plus journal in one sequential pass; seeds from legacy config counts.
+    // A read-only load (replay tools) never compacts or opens the journal. A long
+    // journal is left for the caller to compact (needs_compaction()).
+    void load(const std::string& data_dir, Config& config, bool read_only = false) {
+        dir = data_dir;
+        ref_time = time(NULL);
+        apps.clear();
+        affinities.clear();
+        journal_records = 0;
+        
+        bool have_snapshot = load_snapshot();
+        bool journal_current = load_journal();
+        
+        bool seeded = false;
+        if (!have_snapshot && journal_records == 0 && !config.launch_counts.empty()) {
+            for (const auto& [id, count] : config.launch_counts) {
+                time_t last = config.last_launches.count(id) ? config.last_launches[id] : 0;
+                AppUsage& usage = apps[id];
+                usage.count = count;
+                usage.last = last;
+                usage.frecency = count * decay(static_cast<double>(ref_time - last));
+            }
+            seeded = true;
+        }
+        
+        if (read_only) {
+            // Nothing is written
+        } else if (seeded) {
+            compact();
+        } else {
+            // A stale journal (crash between snapshot and swap) restarts under
+            // this generation; appending to it would lose every later launch
+            open_journal(!journal_current);
+        }
+        
+        // Usage no longer lives in the flat config
+        config.launch_counts.clear();
+        config.last_launches.clear();
+    }
+    
+    void record(const std::string& id, const std::string& query) {
+        time_t now = time(NULL);
+        
+        std::string prefix = normalize_prefix(query);
+        std::string out;
+        put(out, RECORD_MAGIC);
+        put(out, static_cast<uint8_t>(prefix.size()));
+        put(out, static_cast<uint16_t>(id.size()));
+        put(out, static_cast<int64_t>(now));
+        out += id;
+        out += prefix;
+        
+        // O_APPEND and a single write keep records whole
+        if (journal_fd >= 0 && write(journal_fd, out.data(), out.size()) < 0) {
+            std::cerr << "Failed to append to " << journal_path() << std::endl;
+        }
+        if (compacting) {
+            carried += out;
+            carried_records++;
+        }
+        
+        fold(id, prefix, now);
+        journal_records++;
+    }
+    
+    // False while a snapshot is being written, so at most one is in flight
+    bool needs_compaction() const {
+        return !compacting && journal_records >= COMPACT_RECORDS;
+    }
+    
+    bool compaction_pending() const {
+        return compacting;
+    }
+    
+    // Moves history recorded under an old key; the caller compacts afterwards
+    bool migrate(const std::string& from, const std::string& to) {
+        auto it = apps.find(from);
+        if (it == apps.end()) return false;
+        
+        AppUsage& target = apps[to];
+        target.frecency += it->second.frecency;
+        target.count += it->second.count;
+        target.last = std::max(target.last, it->second.last);
+        apps.erase(from);
+        
+        for (auto& [prefix, targets] : affinities) {
+            auto old = targets.find(from);
+            if (old != targets.end()) {
+                targets[to] += old->second;
+                targets.erase(old);
+            }
+        }
+        return true;
+    }
+    
+    // Writes a snapshot for the next generation, then starts an empty journal
+    void compact() {
+        bool written = Config::write_file_atomic(snapshot_path(), begin_compaction());
+        finish_compaction(written);
+    }
+    
+    // Split compaction: the caller writes the returned bytes to snapshot_path()
+    // (on any thread) and then calls finish_compaction() with the result
+    std::string begin_compaction() {
+        // Rebase every score to now so the snapshot time is accurate
+        time_t now = time(NULL);
+        double scale = decay(static_cast<double>(now - ref_time));
+        ref_time = now;
+        for (auto& [id, usage] : apps) {
+            usage.frecency *= scale;
+        }
+        for (auto& [prefix, targets] : affinities) {
+            for (auto& [id, weight] : targets) {
+                weight *= scale;
+            }
+        }
+        
+        std::string out;
+        put(out, SNAPSHOT_MAGIC);
+        put(out, generation + 1);
+        put(out, static_cast<int64_t>(ref_time));
+        put(out, static_cast<uint32_t>(apps.size()));
+        for (const auto& [id, usage] : apps) {
+            put(out, static_cast<uint16_t>(id.size()));
+            out += id;
+            put(out, usage.frecency);
+            put(out, usage.count);
+            put(out, static_cast<int64_t>(usage.last));
+        }
+        
+        std::string entries;
+        uint32_t affinity_count = 0;
+        for (auto& [prefix, targets] : affinities) {
+            for (const auto& [id, weight] : targets) {
+                if (weight < MIN_AFFINITY) continue;
+                put(entries, static_cast<uint8_t>(prefix.size()));
+                entries += prefix;
+                put(entries, static_cast<uint16_t>(id.size()));
+                entries += id;
+                put(entries, weight);
+                affinity_count++;
+            }
+        }
+        put(out, affinity_count);
+        out += entries;
+        
+        compacting = true;
+        carried.clear();
+        carried_records = 0;
+        return out;
+    }
+    
+    // The journal is only swapped once the snapshot is on disk; launches
+    // recorded since begin_compaction() are not in it and move to the new journal
+    void finish_compaction(bool written) {
+        compacting = false;
+        if (!written) {
+            std::cerr << "Failed to write " << snapshot_path() << std::endl;
+            if (journal_fd < 0) open_journal(false);
+        } else {
+            generation++;
+            journal_records = carried_records;
+            if (open_journal(true) && !carried.empty() &&
+                write(journal_fd, carried.data(), carried.size()) < 0) {
+                std::cerr << "Failed to append to " << journal_path() << std::endl;
+            }
+        }
+        carried.clear();
+        carried_records = 0;
+    }
+    
+    const AppUsage* usage(const std::string& id) const {
+        auto it = apps.find(id);
+        return it == apps.end() ? nullptr : &it->second;
+    }
+    
+    // Looked up once per query; per-app lookups in the result are O(1)
+    const AffinityMap* affinities_for(const std::string& query) const {
+        auto it = affinities.find(normalize_prefix(query));
+        return it == affinities.end() ? nullptr : &it->second;
+    }
+};
+
+#endif
@@ -1,8 +1,9 @@
 /*
  * Futuristic Launcher with Shader Background
  * 
- * Build: g++ futuristic-launcher-shader.cpp -o futuristic-launcher `pkg-config --cflags --libs gtk4 gtk4-layer-shell-0 epoxy` -std=c++17
- * Alternative for GTK3: g++ futuristic-launcher-shader.cpp -o futuristic-launcher `pkg-config --cflags --libs gtk+-3.0 gtk-layer-shell-0 epoxy` -std=c++17
+ * Build: g++ futuristic-launcher.cpp core/desktop.cpp core/search.cpp core/keystrokes.cpp core/dmenu.cpp core/thread_pool.cpp -o futuristic-launcher `pkg-config --cflags --libs gtk4 gtk4-layer-shell-0 epoxy` -std=c++17 -pthread
+ * Alternative for GTK3: g++ futuristic-launcher.cpp core/desktop.cpp core/search.cpp core/keystrokes.cpp core/dmenu.cpp core/thread_pool.cpp -o futuristic-launcher `pkg-config --cflags --libs gtk+-3.0 gtk-layer-shell-0 epoxy` -std=c++17 -pthread
+ * Parsing, search, config and history live in core/ and build without GTK (make test, make bench).
  * 
  * Requires: gtk-layer-shell, epoxy for OpenGL
  * 
@@ -12,6 +13,8 @@
 #include <gtk/gtk.h>
 #include <epoxy/gl.h>
 #include <string>
+#include <string_view>
+#include <array>
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -20,16 +23,51 @@
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <unordered_map>
+#include <cstdint>
 #include <set>
 #include <cctype>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <sys/file.h>
+#include <fcntl.h>
+#include <csignal>
 #include <unistd.h>
 #include <ctime>
 #include <cmath>
 #include <regex>
-#include <sys/sysinfo.h>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <pthread.h>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <glib-unix.h>
+#include <spawn.h>
+#include <elf.h>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "core/profile.h"
+#include "core/config.h"
+#include "core/control.h"
+#include "core/desktop.h"
+#include "core/usage.h"
+#include "core/catalog.h"
+#include "core/search.h"
+#include "core/keystrokes.h"
+#include "core/metrics.h"
+#include "core/dmenu.h"
+#include "core/thread_pool.h"
 
 // Include layer shell if available
 #if defined(GDK_WINDOWING_WAYLAND) || !defined(GDK_WINDOWING_X11)
@@ -137,6 +175,8 @@ const char* fragment_shader_source = R"(
    
     uniform float time;
     uniform vec2 resolution;
+    uniform vec3 tint;
+    uniform float tint_mix;  // 0 unless morphing
 
     #define iTime time
     #define iResolution resolution
@@ -259,6 +299,9 @@ const char* fragment_shader_source = R"(
 
         col *= pow( 16.0*q.x*q.y*(1.0-q.x)*(1.0-q.y), 0.12)*0.7+0.3;
         
+        // Theme tint, interpolated on the CPU while morphing
+        col = mix(col, vec3(dot(col, vec3(0.299, 0.587, 0.114))) * tint * 1.8, tint_mix);
+        
         // Rounded corners with bevel
         vec2 uv = fragCoord * iResolution.xy;
         float radius = 12.0;
@@ -282,16 +325,6 @@ const char* fragment_shader_source = R"(
 )";
 
 // Theme colors
-enum Theme {
-    THEME_BLUE,
-    THEME_PURPLE,
-    THEME_GREEN,
-    THEME_RED,
-    THEME_ORANGE,
-    THEME_CYAN,
-    THEME_MORPH
-};
-
 struct ThemeColors {
     std::string primary;
     std::string secondary;
@@ -310,361 +343,1645 @@ std::map<Theme, ThemeColors> theme_palette = {
     {THEME_MORPH, {"150, 150, 200", "180, 180, 220", "165, 165, 210", "10, 10, 15", "15, 15, 20"}}
 };
 
-struct DesktopApp {
-    std::string name;
-    std::string exec;
-    std::string icon;
-    std::string comment;
-    std::string categories;
-    bool no_display = false;
-    int launch_count = 0;
-    time_t last_launch = 0;
-    bool is_favorite = false;
+constexpr int THEME_COUNT = THEME_MORPH + 1;
+
+// "r, g, b" as 0..1 floats
+struct Rgb {
+    float r = 0.0f, g = 0.0f, b = 0.0f;
+    
+    static Rgb parse(const std::string& triple) {
+        int r = 0, g = 0, b = 0;
+        sscanf(triple.c_str(), "%d, %d, %d", &r, &g, &b);
+        return {r / 255.0f, g / 255.0f, b / 255.0f};
+    }
+    
+    static Rgb mix(const Rgb& from, const Rgb& to, float t) {
+        return {from.r + (to.r - from.r) * t, from.g + (to.g - from.g) * t, from.b + (to.b - from.b) * t};
+    }
+};
+
+// Background render modes, cheapest last
+enum RenderMode {
+    RENDER_FULL,
+    RENDER_REDUCED,
+    RENDER_STATIC
 };
 
-struct Config {
-    Theme current_theme = THEME_BLUE;
-    int icon_size = 96;
-    float transparency = 0.90f;
-    std::set<std::string> favorites;
-    std::map<std::string, int> launch_counts;
-    std::map<std::string, time_t> last_launches;
-    
-    bool validate() {
-        if (icon_size < 16 || icon_size > 256) icon_size = 96;
-        if (transparency < 0.0f || transparency > 1.0f) transparency = 0.98f;
-        if (current_theme < THEME_BLUE || current_theme > THEME_MORPH) current_theme = THEME_BLUE;
-        return true;
+// Fixed-size history, oldest samples are overwritten
+template <typename T, size_t N>
+struct RingBuffer {
+    std::array<T, N> data{};
+    size_t head = 0;
+    size_t count = 0;
+
+    void push(T value) {
+        data[head] = value;
+        head = (head + 1) % N;
+        if (count < N) count++;
+    }
+
+    size_t size() const { return count; }
+
+    // i = 0 is the oldest sample
+    T at(size_t i) const {
+        return data[(head + N - count + i) % N];
     }
+
+    T percentile(double p) const {
+        if (count == 0) return T();
+        std::vector<T> sorted(count);
+        for (size_t i = 0; i < count; i++) sorted[i] = at(i);
+        size_t rank = std::min(count - 1, static_cast<size_t>(p / 100.0 * count));
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sorted[rank];
+    }
+};
+
+// Render loop timings, sampled from the frame clock and on_gl_render()
+struct FrameStats {
+    static constexpr size_t HISTORY = 512;
+
+    RingBuffer<float, HISTORY> frame_ms;     // before-paint -> after-paint, whole widget tree
+    RingBuffer<float, HISTORY> render_ms;    // CPU time spent in on_gl_render()
+    RingBuffer<float, HISTORY> gpu_ms;       // GL_TIME_ELAPSED of the shader pass
+    RingBuffer<float, HISTORY> interval_ms;  // frame clock interval
+    uint64_t frames = 0;
+    uint64_t missed_vblanks = 0;
+    gint64 paint_start = 0;
+    gint64 last_frame_time = 0;
+
+    static std::string describe(const char* label, const RingBuffer<float, HISTORY>& series) {
+        if (series.size() == 0) return std::string(label) + " n/a";
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%s %.1f/%.1f/%.1f", label,
+                 series.percentile(50), series.percentile(95), series.percentile(99));
+        return buf;
+    }
+
+    std::string overlay_text() const {
+        char gpu[16] = "n/a";
+        if (gpu_ms.size()) snprintf(gpu, sizeof(gpu), "%.1f", gpu_ms.percentile(95));
+        char buf[128];
+        snprintf(buf, sizeof(buf), "p95 frame %.1f | gl %.1f | gpu %s | miss %llu",
+                 frame_ms.percentile(95), render_ms.percentile(95), gpu,
+                 (unsigned long long)missed_vblanks);
+        return buf;
+    }
+
+    void dump(std::ostream& out) const {
+        if (frames == 0) return;
+        out << "[frame-stats] " << frames << " frames, " << missed_vblanks << " missed vblanks (p50/p95/p99 ms)\n"
+            << "  " << describe("frame   ", frame_ms) << "\n"
+            << "  " << describe("gl cpu  ", render_ms) << "\n"
+            << "  " << describe("gl gpu  ", gpu_ms) << "\n"
+            << "  " << describe("interval", interval_ms) << std::endl;
+    }
+};
+
+// posix_spawn() without a shell or inherited fds; children are reaped by the main loop
+struct Spawner {
+    LatencyHistogram exec_hist;  // spawn call to exec in the child, microseconds
+    MetricCounter spawned;
+    MetricCounter failures;
     
-    void load() {
-        std::string config_path = std::string(g_get_home_dir()) + "/.config/futuristic-launcher.conf";
-        std::ifstream file(config_path);
-        if (!file.is_open()) return;
-        
-        std::string line;
-        int error_count = 0;
-        
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            
-            size_t eq = line.find('=');
-            if (eq == std::string::npos) continue;
-            
-            std::string key = line.substr(0, eq);
-            std::string value = line.substr(eq + 1);
-            
-            if (value.empty()) continue;
-            
-            try {
-                if (key == "theme") {
-                    int theme_val = std::stoi(value);
-                    if (theme_val >= 0 && theme_val <= 6) {
-                        current_theme = static_cast<Theme>(theme_val);
-                    }
-                } else if (key == "icon_size") {
-                    int size = std::stoi(value);
-                    if (size > 0 && size <= 256) {
-                        icon_size = size;
-                    }
-                } else if (key == "transparency") {
-                    float trans = std::stof(value);
-                    if (trans >= 0.0f && trans <= 1.0f) {
-                        transparency = trans;
-                    }
-                } else if (key == "favorite") {
-                    favorites.insert(value);
-                } else if (key.length() > 6 && key.substr(0, 6) == "count_") {
-                    std::string app_name = key.substr(6);
-                    int count = std::stoi(value);
-                    if (count >= 0) {
-                        launch_counts[app_name] = count;
-                    }
-                } else if (key.length() > 5 && key.substr(0, 5) == "last_") {
-                    std::string app_name = key.substr(5);
-                    long timestamp = std::stol(value);
-                    if (timestamp >= 0) {
-                        last_launches[app_name] = timestamp;
-                    }
-                }
-            } catch (...) {
-                error_count++;
-                continue;
-            }
+    bool spawn(const std::vector<std::string>& argv, std::string_view label) {
+        std::vector<char*> args;
+        for (const auto& arg : argv) {
+            args.push_back(const_cast<char*>(arg.c_str()));
         }
+        args.push_back(nullptr);
         
-        file.close();
-        
-        if (error_count > 10) {
-            std::string backup_path = config_path + ".backup";
-            std::rename(config_path.c_str(), backup_path.c_str());
-        }
-        
-        validate();
-    }
-    
-    void save() {
-        std::string config_dir = std::string(g_get_home_dir()) + "/.config";
-        fs::create_directories(config_dir);
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        #if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+            posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+        #endif
         
-        std::string config_path = config_dir + "/futuristic-launcher.conf";
-        std::ofstream file(config_path);
+        // Own session, clean signal state
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t mask, defaults;
+        sigemptyset(&mask);
+        sigemptyset(&defaults);
+        sigaddset(&defaults, SIGPIPE);
+        posix_spawnattr_setsigmask(&attr, &mask);
+        posix_spawnattr_setsigdefault(&attr, &defaults);
+        short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+        #ifdef POSIX_SPAWN_SETSID
+            flags |= POSIX_SPAWN_SETSID;
+        #endif
+        posix_spawnattr_setflags(&attr, flags);
         
-        file << "# Futuristic Launcher Configuration\n";
-        file << "theme=" << static_cast<int>(current_theme) << "\n";
-        file << "icon_size=" << icon_size << "\n";
-        file << "transparency=" << transparency << "\n";
+        // glibc's posix_spawn returns once the child has exec'd or failed to
+        pid_t pid = 0;
+        gint64 start = g_get_monotonic_time();
+        int err = posix_spawnp(&pid, args[0], &actions, &attr, args.data(), environ);
+        gint64 elapsed = g_get_monotonic_time() - start;
         
-        for (const auto& fav : favorites) {
-            file << "favorite=" << fav << "\n";
-        }
+        posix_spawnattr_destroy(&attr);
+        posix_spawn_file_actions_destroy(&actions);
         
-        for (const auto& [app, count] : launch_counts) {
-            file << "count_" << app << "=" << count << "\n";
+        if (err != 0) {
+            failures.add();
+            std::cerr << "Failed to launch " << label << ": " << g_strerror(err) << std::endl;
+            return false;
         }
         
-        for (const auto& [app, last] : last_launches) {
-            file << "last_" << app << "=" << last << "\n";
-        }
+        spawned.add();
+        exec_hist.add(elapsed);
+        g_child_watch_add(pid, on_child_exit, NULL);
+        return true;
+    }
+    
+    static void on_child_exit(GPid pid, gint status, gpointer user_data) {
+        g_spawn_close_pid(pid);
     }
 };
 
-class FuturisticLauncher {
+// Warms the page cache for binaries that are likely to be launched next: the
+// executable, its interpreter and its DT_NEEDED closure. Runs on an idle-priority
+// thread; the main loop only hands over argv[0]s, newest request wins.
+class Prefetcher {
+public:
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t files = 0;
+        uint64_t bytes = 0;
+        uint64_t pages = 0;
+        uint64_t resident_pages = 0;  // already cached before readahead
+        uint64_t over_budget = 0;
+        uint64_t launches = 0;
+        uint64_t launch_hits = 0;     // launched binary was prefetched beforehand
+    };
+
 private:
-    GtkWidget *window;
-    GtkWidget *search_entry;
-    GtkWidget *app_list;
-    GtkWidget *scrolled_window;
-    GtkWidget *header_box;
-    GtkWidget *stats_label;
-    GtkWidget *power_menu_button;
-    GtkWidget *gl_area;
-    GtkCssProvider *css_provider;
+    static constexpr gint64 REFRESH_US = 300 * G_USEC_PER_SEC;
+    static constexpr gint64 PREDICTION_US = 600 * G_USEC_PER_SEC;
     
-    GLuint shader_program;
-    GLuint vao, vbo;
-    gint64 start_time;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::string> pending;
+    bool has_pending = false;
+    bool stopping = false;
+    size_t budget_bytes = 64 << 20;
+    Stats stats;
+    std::map<std::string, gint64> predicted;  // argv[0] -> last requested
     
-    std::vector<DesktopApp> all_apps;
-    std::vector<DesktopApp> filtered_apps;
-    std::vector<GtkWidget*> icon_widgets;
-    int selected_index = 0;
-    int lock_fd = -1;
-    bool is_visible = false;
-    Config config;
+    // Worker-only state
+    std::map<std::string, std::vector<std::string>> closures;  // binary -> files to warm
+    std::map<std::string, gint64> warmed;                      // file -> last readahead
     
-    guint stats_timer = 0;
-    guint fade_timer = 0;
-    guint morph_timer = 0;
-    double current_opacity = 0.0;
-    bool fading_in = false;
-    int morph_current_theme = 0;
+    std::thread worker;  // last, so the state above exists before it starts
     
-    bool calculator_mode = false;
-    bool web_search_mode = false;
-    bool command_mode = false;
+    static std::string resolve_command(const std::string& command) {
+        if (command.find('/') != std::string::npos) {
+            return access(command.c_str(), X_OK) == 0 ? command : std::string();
+        }
+        const char *path_env = g_getenv("PATH");
+        std::istringstream dirs(path_env ? path_env : "/usr/local/bin:/usr/bin:/bin");
+        for (std::string dir; std::getline(dirs, dir, ':');) {
+            std::string candidate = dir + "/" + command;
+            if (access(candidate.c_str(), X_OK) == 0) return candidate;
+        }
+        return std::string();
+    }
     
-    static constexpr int LAUNCHER_WIDTH = 500;
-    static constexpr int LAUNCHER_HEIGHT = 600;
-    static constexpr int MARGIN_TOP = 50;
-    static constexpr bool POSITION_TOP_LEFT = true;
+    static bool read_at(int fd, void *buffer, size_t size, off_t offset) {
+        return pread(fd, buffer, size, offset) == static_cast<ssize_t>(size);
+    }
     
-    // Shader initialization
-    void init_shaders() {
-        // Compile vertex shader
-        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vs, 1, &vertex_shader_source, NULL);
-        glCompileShader(vs);
-        
-        // Check vertex shader
-        GLint success;
-        glGetShaderiv(vs, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char log[512];
-            glGetShaderInfoLog(vs, 512, NULL, log);
-            std::cerr << "Vertex shader error: " << log << std::endl;
-        }
+    // DT_NEEDED names and RUNPATH/RPATH dirs of a native 64-bit ELF file
+    static bool read_needed(const std::string& path, std::vector<std::string>& needed,
+                            std::vector<std::string>& search_dirs, std::string& interpreter) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
         
-        // Compile fragment shader
-        GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fs, 1, &fragment_shader_source, NULL);
-        glCompileShader(fs);
+        Elf64_Ehdr header;
+        bool ok = read_at(fd, &header, sizeof(header), 0) &&
+                  memcmp(header.e_ident, ELFMAG, SELFMAG) == 0 &&
+                  header.e_ident[EI_CLASS] == ELFCLASS64 &&
+                  header.e_phentsize == sizeof(Elf64_Phdr);
         
-        // Check fragment shader
-        glGetShaderiv(fs, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char log[512];
-            glGetShaderInfoLog(fs, 512, NULL, log);
-            std::cerr << "Fragment shader error: " << log << std::endl;
+        std::vector<Elf64_Phdr> segments;
+        if (ok) {
+            segments.resize(header.e_phnum);
+            ok = read_at(fd, segments.data(), segments.size() * sizeof(Elf64_Phdr), header.e_phoff);
         }
         
-        // Link program
-        shader_program = glCreateProgram();
-        glAttachShader(shader_program, vs);
-        glAttachShader(shader_program, fs);
-        glLinkProgram(shader_program);
+        const Elf64_Phdr *dynamic = nullptr;
+        for (size_t i = 0; ok && i < segments.size(); i++) {
+            if (segments[i].p_type == PT_DYNAMIC) dynamic = &segments[i];
+            if (segments[i].p_type == PT_INTERP && segments[i].p_filesz < PATH_MAX) {
+                interpreter.resize(segments[i].p_filesz);
+                read_at(fd, &interpreter[0], interpreter.size(), segments[i].p_offset);
+                interpreter.resize(strnlen(interpreter.c_str(), interpreter.size()));
+            }
+        }
         
-        // Check program
-        glGetProgramiv(shader_program, GL_LINK_STATUS, &success);
-        if (!success) {
-            char log[512];
-            glGetProgramInfoLog(shader_program, 512, NULL, log);
-            std::cerr << "Shader program error: " << log << std::endl;
+        std::vector<Elf64_Dyn> entries;
+        if (ok && dynamic) {
+            entries.resize(dynamic->p_filesz / sizeof(Elf64_Dyn));
+            ok = read_at(fd, entries.data(), entries.size() * sizeof(Elf64_Dyn), dynamic->p_offset);
         }
         
-        glDeleteShader(vs);
-        glDeleteShader(fs);
+        // DT_STRTAB is a virtual address; map it back through the PT_LOAD segments
+        Elf64_Addr strtab = 0;
+        for (const auto& entry : entries) {
+            if (entry.d_tag == DT_STRTAB) strtab = entry.d_un.d_ptr;
+        }
+        off_t strtab_offset = -1;
+        for (const auto& segment : segments) {
+            if (segment.p_type == PT_LOAD && strtab >= segment.p_vaddr &&
+                strtab < segment.p_vaddr + segment.p_filesz) {
+                strtab_offset = segment.p_offset + (strtab - segment.p_vaddr);
+            }
+        }
         
-        // Create quad
-        float vertices[] = {
-            -1.0f, -1.0f,
-             1.0f, -1.0f,
-            -1.0f,  1.0f,
-             1.0f,  1.0f
+        auto read_string = [&](Elf64_Xword offset) {
+            char buffer[256] = {0};
+            pread(fd, buffer, sizeof(buffer) - 1, strtab_offset + offset);
+            return std::string(buffer);
         };
         
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(0);
-    }
-    
-    static void on_gl_realize(GtkGLArea *area, gpointer user_data) {
-        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
-        gtk_gl_area_make_current(area);
-        
-        if (gtk_gl_area_get_error(area) != NULL) {
-            std::cerr << "GL Area error on realize" << std::endl;
-            return;
+        std::string origin = fs::path(path).parent_path().string();
+        for (const auto& entry : entries) {
+            if (strtab_offset < 0) break;
+            if (entry.d_tag == DT_NEEDED) {
+                needed.push_back(read_string(entry.d_un.d_val));
+            } else if (entry.d_tag == DT_RUNPATH || entry.d_tag == DT_RPATH) {
+                std::istringstream dirs(read_string(entry.d_un.d_val));
+                for (std::string dir; std::getline(dirs, dir, ':');) {
+                    size_t pos = dir.find("$ORIGIN");
+                    if (pos != std::string::npos) dir.replace(pos, 7, origin);
+                    search_dirs.push_back(dir);
+                }
+            }
         }
         
-        launcher->init_shaders();
+        close(fd);
+        return ok;
     }
     
-    static gboolean on_gl_render(GtkGLArea *area, GdkGLContext *context, gpointer user_data) {
-        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
-        
-        glClearColor(0.0, 0.0, 0.0, 0.0);
-        glClear(GL_COLOR_BUFFER_BIT);
-        
-        // Enable blending for transparency
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        
-        glUseProgram(launcher->shader_program);
-        
-        // Calculate time
-        gint64 current_time = g_get_monotonic_time();
-        float time = (current_time - launcher->start_time) / 1000000.0f;
-        
-        // Get resolution (GTK3/4 compatible)
-        int width, height;
-        #if GTK_IS_VERSION_4
-            width = gtk_widget_get_width(GTK_WIDGET(area));
-            height = gtk_widget_get_height(GTK_WIDGET(area));
-        #else
-            GtkAllocation alloc;
-            gtk_widget_get_allocation(GTK_WIDGET(area), &alloc);
-            width = alloc.width;
-            height = alloc.height;
-        #endif
-        
-        glUniform1f(glGetUniformLocation(launcher->shader_program, "time"), time);
-        glUniform2f(glGetUniformLocation(launcher->shader_program, "resolution"), width, height);
+    // Breadth-first over DT_NEEDED; scripts contribute their #! interpreter
+    std::vector<std::string> closure_of(const std::string& binary) {
+        static const char *system_dirs[] = {
+            "/lib64", "/usr/lib64", "/lib/x86_64-linux-gnu", "/usr/lib/x86_64-linux-gnu",
+            "/lib/aarch64-linux-gnu", "/usr/lib/aarch64-linux-gnu", "/usr/lib", "/lib", "/usr/local/lib"
+        };
         
-        glBindVertexArray(launcher->vao);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        std::vector<std::string> files;
+        std::set<std::string> seen;
+        std::vector<std::string> queue = {binary};
         
-        glDisable(GL_BLEND);
+        char shebang[PATH_MAX] = {0};
+        std::ifstream script(binary);
+        if (script.getline(shebang, sizeof(shebang)) && strncmp(shebang, "#!", 2) == 0) {
+            std::string interpreter;
+            std::istringstream(shebang + 2) >> interpreter;
+            if (!interpreter.empty()) queue.push_back(interpreter);
+        }
         
-        return TRUE;
-    }
-    
-    static gboolean gl_tick_callback(GtkWidget *widget, GdkFrameClock *clock, gpointer data) {
-        gtk_gl_area_queue_render(GTK_GL_AREA(widget));
-        return G_SOURCE_CONTINUE;
+        for (size_t i = 0; i < queue.size() && queue.size() < 512; i++) {
+            std::string file = queue[i];
+            if (!seen.insert(file).second) continue;
+            files.push_back(file);
+            
+            std::vector<std::string> needed, search_dirs;
+            std::string interpreter;
+            if (!read_needed(file, needed, search_dirs, interpreter)) continue;
+            if (!interpreter.empty()) queue.push_back(interpreter);
+            
+            for (const char *dir : system_dirs) search_dirs.push_back(dir);
+            for (const auto& name : needed) {
+                for (const auto& dir : search_dirs) {
+                    std::string candidate = dir + "/" + name;
+                    if (access(candidate.c_str(), R_OK) == 0) {
+                        queue.push_back(candidate);
+                        break;
+                    }
+                }
+            }
+        }
+        return files;
     }
     
-    int fuzzy_score(const std::string& str, const std::string& pattern) {
-        std::string str_lower = str;
-        std::string pattern_lower = pattern;
-        std::transform(str_lower.begin(), str_lower.end(), str_lower.begin(), ::tolower);
-        std::transform(pattern_lower.begin(), pattern_lower.end(), pattern_lower.begin(), ::tolower);
+    // Residency is sampled with mincore() first, so hits show up in the stats
+    bool warm(const std::string& file, size_t& budget) {
+        int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return true;
         
-        int score = 0;
-        size_t str_idx = 0;
-        size_t pat_idx = 0;
-        size_t consecutive = 0;
-        
-        while (str_idx < str_lower.length() && pat_idx < pattern_lower.length()) {
-            if (str_lower[str_idx] == pattern_lower[pat_idx]) {
-                score += 1 + consecutive * 5;
-                consecutive++;
-                pat_idx++;
-            } else {
-                consecutive = 0;
-            }
-            str_idx++;
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size == 0) {
+            close(fd);
+            return true;
         }
-        
-        if (pat_idx != pattern_lower.length()) {
-            return 0;
+        size_t size = st.st_size;
+        if (size > budget) {
+            close(fd);
+            return false;
         }
         
-        if (str_lower.find(pattern_lower) != std::string::npos) {
-            score += 50;
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t pages = (size + page - 1) / page;
+        size_t resident = 0;
+        void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            std::vector<unsigned char> residency(pages);
+            if (mincore(map, size, residency.data()) == 0) {
+                for (unsigned char r : residency) resident += r & 1;
+            }
+            munmap(map, size);
         }
         
-        if (str_lower.find(pattern_lower) == 0) {
-            score += 100;
+        if (resident < pages) {
+            readahead(fd, 0, size);
         }
+        close(fd);
+        budget -= size;
         
-        return score;
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.files++;
+        stats.bytes += size;
+        stats.pages += pages;
+        stats.resident_pages += resident;
+        return true;
     }
     
-    std::string get_theme_css() {
-        ThemeColors colors = theme_palette[config.current_theme];
-        std::ostringstream css;
+    void run() {
+        // Idle CPU and I/O priority for this thread only
+        setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+        syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, 0, 3 << 13 /* IOPRIO_CLASS_IDLE */);
         
-        css << R"(
-            window {
-                background: transparent;
-            }
-            
-            scrolledwindow {
-                background: transparent;
-                border: none;
-            }
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return has_pending || stopping; });
+            if (stopping) break;
             
-            list {
-                background: transparent;
-                border: none;
-            }
+            std::vector<std::string> commands;
+            commands.swap(pending);
+            has_pending = false;
+            size_t budget = budget_bytes;
+            lock.unlock();
             
-            row {
-                background: transparent;
-                color: rgba(170, 200, 230, 0.95);
-                border: none;
-                padding: 10px;
-                margin: 4px 8px;
+            gint64 now = g_get_monotonic_time();
+            bool exhausted = false;
+            for (const auto& command : commands) {
+                std::string binary = resolve_command(command);
+                if (binary.empty()) continue;
+                
+                auto cached = closures.find(binary);
+                if (cached == closures.end()) {
+                    cached = closures.emplace(binary, closure_of(binary)).first;
+                }
+                for (const auto& file : cached->second) {
+                    auto last = warmed.find(file);
+                    if (last != warmed.end() && now - last->second < REFRESH_US) continue;
+                    // Too big for what is left; smaller files may still fit
+                    if (!warm(file, budget)) {
+                        exhausted = true;
+                        continue;
+                    }
+                    warmed[file] = now;
+                }
             }
             
-            row:selected {
-                background: transparent;
-                border: none;
+            lock.lock();
+            if (exhausted) stats.over_budget++;
+        }
+    }
+
+public:
+    Prefetcher() : worker(&Prefetcher::run, this) {}
+    
+    ~Prefetcher() {
+        stop();
+    }
+    
+    void set_budget_mb(int megabytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budget_bytes = static_cast<size_t>(std::max(0, megabytes)) << 20;
+    }
+    
+    // Replaces whatever has not been started yet
+    void request(std::vector<std::string> commands) {
+        if (commands.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            gint64 now = g_get_monotonic_time();
+            for (const auto& command : commands) {
+                predicted[command] = now;
             }
-            
-            entry {
-                background: rgba(15, 15, 25, 0.85);
-                color: rgba(180, 230, 255, 1.0);
-                border: 2px solid rgba()" << colors.primary << R"(, 0.5);
-                border-radius: 8px;
-                padding: 12px 16px;
-                font-size: 16px;
-                font-weight: bold;
+            pending = std::move(commands);
+            has_pending = true;
+            stats.requests++;
+        }
+        wake.notify_one();
+    }
+    
+    void note_launch(const std::string& command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.launches++;
+        auto it = predicted.find(command);
+        if (it != predicted.end() && g_get_monotonic_time() - it->second < PREDICTION_US) {
+            stats.launch_hits++;
+        }
+    }
+    
+    Stats snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+    
+    // Drops pending work and joins the thread
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (worker.joinable()) worker.join();
+    }
+};
+
+// Daemon health counters for --stats, --metrics and the Prometheus textfile
+struct DaemonMetrics {
+    MetricCounter searches;
+    LatencyHistogram search_us;    // search() per query
+    MetricCounter list_rebuilds;
+    MetricCounter list_tiles;      // app tiles created by update_list()
+    MetricCounter icon_hits;
+    MetricCounter icon_misses;
+    MetricCounter launches;
+    LatencyHistogram frame_us;     // before-paint -> after-paint
+};
+
+// Stages of the panel-click-to-usable-launcher path, in the order they happen
+enum ShowStage {
+    STAGE_CLIENT_START,
+    STAGE_SENT,
+    STAGE_RECEIVED,
+    STAGE_TOGGLE,
+    STAGE_FADE_START,
+    STAGE_FILTERED,
+    STAGE_LISTED,
+    STAGE_GL_RENDER,
+    STAGE_PAINTED,
+    STAGE_PRESENTED,
+    STAGE_COUNT
+};
+
+// Monotonic timestamps of one show, from the client process to the presented frame
+// Trace lines are buffered while the launcher is shown and appended with one
+// write on hide, so no show or keystroke waits on the file. The file starts over
+// once it would pass MAX_BYTES.
+struct TraceLog {
+    static constexpr off_t MAX_BYTES = 1 << 20;
+    static constexpr size_t MAX_PENDING = 64 << 10;
+    
+    std::string path;
+    std::string pending;
+    
+    void add(const std::string& line) {
+        pending += line;
+        if (pending.size() >= MAX_PENDING) flush();
+    }
+    
+    void flush() {
+        if (pending.empty()) return;
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size + static_cast<off_t>(pending.size()) > MAX_BYTES &&
+                ftruncate(fd, 0) < 0) {
+                g_warning("Failed to truncate %s", path.c_str());
+            }
+            if (write(fd, pending.data(), pending.size()) < 0) {
+                g_warning("Failed to append to %s", path.c_str());
+            }
+            close(fd);
+        }
+        pending.clear();
+    }
+};
+
+struct ShowTrace {
+    static constexpr const char* STAGE_NAMES[STAGE_COUNT] = {
+        "client", "sent", "received", "toggle", "fade", "filter", "list", "gl", "paint", "present"
+    };
+    
+    gint64 stamps[STAGE_COUNT] = {0};
+    bool active = false;
+    gint64 painted_frame = -1;
+    
+    LatencyHistogram stage_hist[STAGE_COUNT];
+    LatencyHistogram total_hist;
+    uint64_t over_budget = 0;
+    
+    void begin(gint64 client_start, gint64 sent, gint64 received) {
+        std::fill(std::begin(stamps), std::end(stamps), 0);
+        stamps[STAGE_CLIENT_START] = client_start;
+        stamps[STAGE_SENT] = sent;
+        stamps[STAGE_RECEIVED] = received;
+        painted_frame = -1;
+        active = true;
+        mark(STAGE_TOGGLE);
+    }
+    
+    void mark(ShowStage stage, gint64 when = 0) {
+        if (!active || stamps[stage] != 0) return;
+        stamps[stage] = when ? when : g_get_monotonic_time();
+    }
+    
+    // Records per-stage deltas and adds one line to the trace log
+    void finish(TraceLog& log, int budget_ms) {
+        active = false;
+        
+        std::ostringstream line;
+        gint64 first = 0;
+        gint64 previous = 0;
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            if (stamps[i] == 0) continue;
+            if (first == 0) {
+                first = previous = stamps[i];
+                continue;
+            }
+            gint64 delta = stamps[i] - previous;
+            stage_hist[i].add(delta);
+            line << " " << STAGE_NAMES[i] << "=" << delta;
+            previous = stamps[i];
+        }
+        
+        gint64 total = previous - first;
+        total_hist.add(total);
+        
+        log.add("show total=" + std::to_string(total) + line.str() + "\n");
+        
+        if (total > budget_ms * 1000LL) {
+            over_budget++;
+            g_warning("Show latency %.1f ms exceeds the %d ms budget", total / 1000.0, budget_ms);
+        }
+    }
+    
+    void dump(std::ostream& out) const {
+        if (total_hist.count() == 0) return;
+        out << "[show-latency] " << total_hist.count() << " shows, " << over_budget
+            << " over budget (p50/p95/p99 us, log2 buckets)\n"
+            << "  total    " << total_hist.percentile(50) << "/" << total_hist.percentile(95)
+            << "/" << total_hist.percentile(99) << "\n";
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            if (stage_hist[i].count() == 0) continue;
+            out << "  " << std::left << std::setw(9) << STAGE_NAMES[i] << std::right
+                << stage_hist[i].percentile(50) << "/" << stage_hist[i].percentile(95)
+                << "/" << stage_hist[i].percentile(99) << "\n";
+        }
+        out << std::flush;
+    }
+};
+
+// Stages of an injected keystroke (control "key" command), from receipt to the presented results
+enum KeyStage {
+    KEY_RECEIVED,
+    KEY_FILTERED,
+    KEY_LISTED,
+    KEY_PAINTED,
+    KEY_PRESENTED,
+    KEY_STAGE_COUNT
+};
+
+// Keystroke-to-frame latency, logged next to the show traces
+struct KeyTrace {
+    static constexpr const char* STAGE_NAMES[KEY_STAGE_COUNT] = {
+        "received", "filter", "list", "paint", "present"
+    };
+    
+    gint64 stamps[KEY_STAGE_COUNT] = {0};
+    bool active = false;
+    gint64 painted_frame = -1;
+    
+    LatencyHistogram total_hist;
+    
+    void begin(gint64 received) {
+        std::fill(std::begin(stamps), std::end(stamps), 0);
+        stamps[KEY_RECEIVED] = received;
+        painted_frame = -1;
+        active = true;
+    }
+    
+    void mark(KeyStage stage, gint64 when = 0) {
+        if (!active || stamps[stage] != 0) return;
+        stamps[stage] = when ? when : g_get_monotonic_time();
+    }
+    
+    void finish(TraceLog& log) {
+        active = false;
+        
+        std::ostringstream line;
+        gint64 previous = stamps[KEY_RECEIVED];
+        for (int i = KEY_FILTERED; i < KEY_STAGE_COUNT; i++) {
+            if (stamps[i] == 0) continue;
+            line << " " << STAGE_NAMES[i] << "=" << stamps[i] - previous;
+            previous = stamps[i];
+        }
+        
+        gint64 total = previous - stamps[KEY_RECEIVED];
+        total_hist.add(total);
+        
+        log.add("key total=" + std::to_string(total) + line.str() + "\n");
+    }
+    
+    void dump(std::ostream& out) const {
+        if (total_hist.count() == 0) return;
+        out << "[key-latency] " << total_hist.count() << " injected keys, p50/p95/p99 us "
+            << total_hist.percentile(50) << "/" << total_hist.percentile(95)
+            << "/" << total_hist.percentile(99) << std::endl;
+    }
+};
+
+// Picks the background render mode from battery, thermal and CPU pressure state
+struct PowerGovernor {
+    // Overridable so fixture directories can stand in for the real trees
+    std::string sysfs_root = "/sys";
+    std::string procfs_root = "/proc";
+    
+    RenderMode mode = RENDER_FULL;
+    RenderMode candidate = RENDER_FULL;
+    int candidate_samples = 0;
+    
+    bool on_battery = false;
+    int battery_percent = -1;
+    double max_temp_c = -1.0;
+    double cpu_pressure = -1.0;
+    
+    static constexpr int BATTERY_MARGIN = 5;
+    static constexpr int THERMAL_MARGIN = 5;
+    static constexpr int PRESSURE_MARGIN = 10;
+    
+    static std::string read_line(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+    
+    void sample() {
+        on_battery = false;
+        battery_percent = -1;
+        max_temp_c = -1.0;
+        cpu_pressure = -1.0;
+        
+        bool mains_online = false;
+        bool discharging = false;
+        std::error_code ec;
+        
+        for (const auto& entry : fs::directory_iterator(sysfs_root + "/class/power_supply", ec)) {
+            std::string dir = entry.path().string();
+            std::string type = read_line(dir + "/type");
+            if (type == "Mains" || type == "USB") {
+                if (read_line(dir + "/online") == "1") mains_online = true;
+            } else if (type == "Battery") {
+                if (read_line(dir + "/status") == "Discharging") discharging = true;
+                std::string capacity = read_line(dir + "/capacity");
+                if (!capacity.empty()) {
+                    int percent = std::atoi(capacity.c_str());
+                    if (battery_percent < 0 || percent < battery_percent) battery_percent = percent;
+                }
+            }
+        }
+        on_battery = discharging && !mains_online;
+        
+        for (const auto& entry : fs::directory_iterator(sysfs_root + "/class/thermal", ec)) {
+            if (entry.path().filename().string().rfind("thermal_zone", 0) != 0) continue;
+            std::string temp = read_line(entry.path().string() + "/temp");
+            if (temp.empty()) continue;
+            max_temp_c = std::max(max_temp_c, std::atol(temp.c_str()) / 1000.0);
+        }
+        
+        // "some avg10=1.23 avg60=..."
+        std::string pressure = read_line(procfs_root + "/pressure/cpu");
+        size_t avg = pressure.find("avg10=");
+        if (avg != std::string::npos) {
+            cpu_pressure = std::atof(pressure.c_str() + avg + 6);
+        }
+    }
+    
+    // Relaxing back to a more expensive mode needs to clear the threshold by a margin
+    RenderMode target(const Config& config) const {
+        switch (config.render_policy) {
+            case POLICY_FULL: return RENDER_FULL;
+            case POLICY_REDUCED: return RENDER_REDUCED;
+            case POLICY_STATIC: return RENDER_STATIC;
+            case POLICY_AUTO: break;
+        }
+        
+        int battery_margin = mode == RENDER_STATIC ? BATTERY_MARGIN : 0;
+        int static_margin = mode == RENDER_STATIC ? THERMAL_MARGIN : 0;
+        int reduce_margin = mode != RENDER_FULL ? THERMAL_MARGIN : 0;
+        int pressure_margin = mode != RENDER_FULL ? PRESSURE_MARGIN : 0;
+        
+        if (on_battery && battery_percent >= 0 &&
+            battery_percent <= config.low_battery_percent + battery_margin) {
+            return RENDER_STATIC;
+        }
+        if (max_temp_c >= config.thermal_static_c - static_margin) {
+            return RENDER_STATIC;
+        }
+        if (on_battery ||
+            max_temp_c >= config.thermal_reduce_c - reduce_margin ||
+            cpu_pressure >= config.pressure_reduce - pressure_margin) {
+            return RENDER_REDUCED;
+        }
+        return RENDER_FULL;
+    }
+    
+    // Returns true when the mode changed; a new target must hold for several samples
+    bool update(const Config& config) {
+        sample();
+        RenderMode wanted = target(config);
+        
+        if (wanted == mode) {
+            candidate_samples = 0;
+            return false;
+        }
+        
+        if (wanted != candidate) {
+            candidate = wanted;
+            candidate_samples = 0;
+        }
+        
+        bool forced = config.render_policy != POLICY_AUTO;
+        if (!forced && ++candidate_samples < config.governor_hold_samples) {
+            return false;
+        }
+        
+        mode = wanted;
+        candidate_samples = 0;
+        return true;
+    }
+};
+
+// CPU% and MemAvailable from /proc through fds held open for the daemon's lifetime
+struct SystemSampler {
+    static constexpr size_t HISTORY = 60;
+    
+    int stat_fd = -1;
+    int meminfo_fd = -1;
+    uint64_t prev_busy = 0;
+    uint64_t prev_total = 0;
+    
+    double cpu_percent = 0.0;
+    long mem_total_mb = 0;
+    long mem_available_mb = 0;
+    RingBuffer<float, HISTORY> cpu_history;
+    RingBuffer<float, HISTORY> mem_history;  // percent in use
+    
+    ~SystemSampler() {
+        if (stat_fd >= 0) close(stat_fd);
+        if (meminfo_fd >= 0) close(meminfo_fd);
+    }
+    
+    // Also takes the baseline, so the first real sample already has a delta
+    void open_files(const std::string& procfs_root) {
+        stat_fd = open((procfs_root + "/stat").c_str(), O_RDONLY | O_CLOEXEC);
+        meminfo_fd = open((procfs_root + "/meminfo").c_str(), O_RDONLY | O_CLOEXEC);
+        sample_cpu();
+    }
+    
+    static bool read_head(int fd, char *buffer, size_t size) {
+        if (fd < 0) return false;
+        ssize_t n = pread(fd, buffer, size - 1, 0);
+        buffer[n > 0 ? n : 0] = '\0';
+        return n > 0;
+    }
+    
+    // Aggregate line: user nice system idle iowait irq softirq steal
+    bool sample_cpu() {
+        char buffer[256];
+        if (!read_head(stat_fd, buffer, sizeof(buffer)) || strncmp(buffer, "cpu ", 4) != 0) return false;
+        
+        uint64_t fields[8];
+        char *cursor = buffer + 4;
+        uint64_t total = 0;
+        for (uint64_t& field : fields) {
+            field = strtoull(cursor, &cursor, 10);
+            total += field;
+        }
+        uint64_t busy = total - fields[3] - fields[4];
+        
+        if (prev_total != 0 && total > prev_total) {
+            cpu_percent = 100.0 * (busy - prev_busy) / (total - prev_total);
+        }
+        prev_busy = busy;
+        prev_total = total;
+        return true;
+    }
+    
+    // MemTotal and MemAvailable are the first and third lines
+    bool sample_memory() {
+        char buffer[256];
+        if (!read_head(meminfo_fd, buffer, sizeof(buffer))) return false;
+        
+        const char *total = strstr(buffer, "MemTotal:");
+        const char *available = strstr(buffer, "MemAvailable:");
+        if (!total || !available) return false;
+        mem_total_mb = strtol(total + 9, NULL, 10) / 1024;
+        mem_available_mb = strtol(available + 13, NULL, 10) / 1024;
+        return true;
+    }
+    
+    void sample() {
+        if (sample_cpu()) {
+            cpu_history.push(static_cast<float>(cpu_percent));
+        }
+        if (sample_memory() && mem_total_mb > 0) {
+            mem_history.push(100.0f * (mem_total_mb - mem_available_mb) / mem_total_mb);
+        }
+    }
+    
+    // Newest `width` samples as block characters, percent scale
+    static void append_sparkline(std::string& out, const RingBuffer<float, HISTORY>& history, size_t width) {
+        static const char* bars[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+        size_t start = history.size() > width ? history.size() - width : 0;
+        for (size_t i = start; i < history.size(); i++) {
+            int level = static_cast<int>(history.at(i) / 100.0f * 8.0f);
+            out += bars[std::clamp(level, 0, 7)];
+        }
+    }
+};
+
+// Top processes from /proc/[pid]/stat on a worker thread that only runs while
+// the panel is open. Per-pid state survives between samples: a pid's name is
+// taken from its first read, later passes only re-read stat into one buffer.
+class ProcessSampler {
+public:
+    struct Row {
+        pid_t pid = 0;
+        std::string name;
+        double cpu_percent = 0.0;
+        long rss_kb = 0;
+    };
+    
+    struct Cost {
+        gint64 last_us = 0;
+        gint64 budget_us = 0;
+        size_t pids = 0;
+        size_t refreshed = 0;  // visited this pass
+        size_t reread = 0;     // of those, stat actually read
+        uint64_t over_budget = 0;
+    };
+    
+    static constexpr size_t TOP = 12;
+
+private:
+    struct PidState {
+        std::string name;
+        uint64_t cpu_ticks = 0;
+        gint64 read_at = 0;
+        double cpu_percent = 0.0;
+        long rss_kb = 0;
+        uint32_t seen = 0;  // generation of the last directory scan that listed it
+        int64_t dir_mtime_ns = 0;  // /proc/<pid> inode time; differs once the pid is reused
+        bool idle = false;         // no CPU ticks between its last two reads
+        uint32_t skipped = 0;      // passes skipped since the last read
+    };
+    
+    static constexpr auto INTERVAL = std::chrono::seconds(1);
+    static constexpr gint64 STALE_US = 3 * G_USEC_PER_SEC;
+    static constexpr uint32_t IDLE_REFRESH = 8;  // passes between reads of an idle pid
+    
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool active = false;
+    bool stopping = false;
+    bool by_memory = false;
+    std::string procfs_root = "/proc";
+    std::vector<Row> top;
+    Cost cost;
+    
+    // Worker-only
+    std::unordered_map<pid_t, PidState> pids;
+    std::vector<pid_t> order;  // refresh order; resumes at cursor after an over-budget pass
+    size_t cursor = 0;
+    uint32_t generation = 0;
+    gint64 last_sample = 0;
+    char buffer[1024];
+    char path[PATH_MAX];
+    
+    std::thread worker;  // last, so the state above exists before it starts
+    
+    // Fields after the last ')': 3 state ... 14 utime, 15 stime ... 24 rss
+    bool read_stat(const std::string& root, pid_t pid, PidState& state, gint64 now) {
+        snprintf(path, sizeof(path), "%s/%d/stat", root.c_str(), pid);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (n <= 0) return false;
+        buffer[n] = '\0';
+        
+        char *open_paren = strchr(buffer, '(');
+        char *close_paren = strrchr(buffer, ')');
+        if (!open_paren || !close_paren || close_paren < open_paren) return false;
+        if (state.name.empty()) {
+            state.name.assign(open_paren + 1, close_paren - open_paren - 1);
+        }
+        
+        uint64_t utime = 0, stime = 0;
+        long rss_pages = 0;
+        char *field = close_paren + 2;
+        for (int index = 3; field && index <= 24; index++) {
+            if (index == 14) utime = strtoull(field, NULL, 10);
+            if (index == 15) stime = strtoull(field, NULL, 10);
+            if (index == 24) rss_pages = strtol(field, NULL, 10);
+            field = strchr(field, ' ');
+            if (field) field++;
+        }
+        
+        uint64_t ticks = utime + stime;
+        state.idle = state.read_at != 0 && ticks == state.cpu_ticks;
+        state.skipped = 0;
+        if (state.read_at != 0 && now > state.read_at && ticks >= state.cpu_ticks) {
+            double seconds = (now - state.read_at) / static_cast<double>(G_USEC_PER_SEC);
+            state.cpu_percent = 100.0 * (ticks - state.cpu_ticks) / sysconf(_SC_CLK_TCK) / seconds;
+        }
+        state.cpu_ticks = ticks;
+        state.read_at = now;
+        state.rss_kb = rss_pages * (sysconf(_SC_PAGESIZE) / 1024);
+        return true;
+    }
+    
+    // Only changed pids are re-read: one that was idle at its last read and whose
+    // /proc/<pid> is still the same directory is skipped, except every
+    // IDLE_REFRESH passes so a process waking up is noticed within seconds
+    bool needs_read(const std::string& root, pid_t pid, PidState& state) {
+        snprintf(path, sizeof(path), "%s/%d", root.c_str(), pid);
+        struct stat st;
+        if (stat(path, &st) < 0) return false;  // exited since the directory scan
+        
+        int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        if (mtime_ns != state.dir_mtime_ns) {
+            if (state.dir_mtime_ns != 0) {
+                // Reused pid: a different process, so no name or CPU delta carries over
+                uint32_t seen = state.seen;
+                state = PidState();
+                state.seen = seen;
+            }
+            state.dir_mtime_ns = mtime_ns;
+            return true;
+        }
+        if (state.read_at == 0 || !state.idle) return true;
+        return ++state.skipped >= IDLE_REFRESH;
+    }
+    
+    void sample(const std::string& root, gint64 budget_us, bool sort_by_memory) {
+        gint64 start = g_get_monotonic_time();
+        
+        // Deltas across a closed panel would be meaningless
+        if (last_sample != 0 && start - last_sample > STALE_US) {
+            pids.clear();
+            order.clear();
+            cursor = 0;
+        }
+        last_sample = start;
+        
+        generation++;
+        if (DIR *dir = opendir(root.c_str())) {
+            while (struct dirent *entry = readdir(dir)) {
+                if (!isdigit(static_cast<unsigned char>(entry->d_name[0]))) continue;
+                pid_t pid = static_cast<pid_t>(atoi(entry->d_name));
+                auto [it, inserted] = pids.try_emplace(pid);
+                it->second.seen = generation;
+                if (inserted) order.push_back(pid);
+            }
+            closedir(dir);
+        }
+        
+        // Exited pids
+        order.erase(std::remove_if(order.begin(), order.end(), [this](pid_t pid) {
+            auto it = pids.find(pid);
+            if (it->second.seen == generation) return false;
+            pids.erase(it);
+            return true;
+        }), order.end());
+        
+        // Refresh as many pids as the budget allows, continuing where the last pass stopped
+        size_t refreshed = 0;
+        size_t reread = 0;
+        bool over_budget = false;
+        if (!order.empty()) cursor %= order.size();
+        while (refreshed < order.size()) {
+            gint64 now = g_get_monotonic_time();
+            if (now - start > budget_us) {
+                over_budget = true;
+                break;
+            }
+            pid_t pid = order[(cursor + refreshed) % order.size()];
+            PidState& state = pids[pid];
+            if (needs_read(root, pid, state)) {
+                read_stat(root, pid, state, now);
+                reread++;
+            }
+            refreshed++;
+        }
+        cursor = order.empty() ? 0 : (cursor + refreshed) % order.size();
+        
+        std::vector<const std::pair<const pid_t, PidState>*> ranked;
+        ranked.reserve(pids.size());
+        for (const auto& entry : pids) {
+            if (entry.second.read_at != 0) ranked.push_back(&entry);
+        }
+        size_t count = std::min(TOP, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+            [sort_by_memory](const auto *a, const auto *b) {
+                if (sort_by_memory) return a->second.rss_kb > b->second.rss_kb;
+                if (a->second.cpu_percent != b->second.cpu_percent) {
+                    return a->second.cpu_percent > b->second.cpu_percent;
+                }
+                return a->second.rss_kb > b->second.rss_kb;
+            });
+        
+        gint64 elapsed = g_get_monotonic_time() - start;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        top.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            top[i].pid = ranked[i]->first;
+            top[i].name = ranked[i]->second.name;
+            top[i].cpu_percent = ranked[i]->second.cpu_percent;
+            top[i].rss_kb = ranked[i]->second.rss_kb;
+        }
+        cost.last_us = elapsed;
+        cost.budget_us = budget_us;
+        cost.pids = order.size();
+        cost.refreshed = refreshed;
+        cost.reread = reread;
+        if (over_budget) cost.over_budget++;
+    }
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return active || stopping; });
+            if (stopping) break;
+            
+            std::string root = procfs_root;
+            gint64 budget_us = cost.budget_us;
+            bool sort_by_memory = by_memory;
+            lock.unlock();
+            sample(root, budget_us, sort_by_memory);
+            lock.lock();
+            
+            wake.wait_for(lock, INTERVAL, [this] { return stopping || !active; });
+        }
+    }
+
+public:
+    ProcessSampler() : worker(&ProcessSampler::run, this) {}
+    
+    ~ProcessSampler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (worker.joinable()) worker.join();
+    }
+    
+    void start(const std::string& root, gint64 budget_us) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            procfs_root = root;
+            cost.budget_us = budget_us;
+            active = true;
+        }
+        wake.notify_one();
+    }
+    
+    void pause() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active = false;
+        }
+        wake.notify_one();
+    }
+    
+    // Takes effect from the next sample
+    void set_sort_by_memory(bool memory) {
+        std::lock_guard<std::mutex> lock(mutex);
+        by_memory = memory;
+    }
+    
+    void snapshot(std::vector<Row>& rows, Cost& sample_cost) {
+        std::lock_guard<std::mutex> lock(mutex);
+        rows = top;
+        sample_cost = cost;
+    }
+};
+
+class FuturisticLauncher {
+private:
+    GtkWidget *window;
+    GtkWidget *search_entry;
+    GtkWidget *app_list;
+    GtkWidget *scrolled_window;
+    GtkWidget *header_box;
+    GtkWidget *stats_label;
+    GtkWidget *debug_label;
+    GtkWidget *power_menu_button;
+    GtkWidget *process_button;
+    GtkWidget *process_panel;
+    GtkWidget *process_sort_button;
+    GtkWidget *process_cost_label;
+    std::array<GtkWidget*, ProcessSampler::TOP> process_labels;
+    std::array<GtkWidget*, ProcessSampler::TOP> process_kill_buttons;
+    GtkWidget *power_panel;
+    GtkWidget *power_hint;
+    std::array<GtkWidget*, 3> power_buttons;
+    GtkWidget *gl_area = nullptr;
+    std::array<GtkCssProvider*, THEME_COUNT> theme_providers{};  // parsed on first use
+    GtkCssProvider *active_provider = nullptr;
+    
+    GLuint shader_program = 0;
+    GLuint vao = 0, vbo = 0;
+    gint64 start_time;
+    
+    // Frame timing instrumentation
+    static constexpr int GPU_QUERY_COUNT = 4;
+    FrameStats frame_stats;
+    GLuint gpu_queries[GPU_QUERY_COUNT] = {0};
+    bool gpu_query_pending[GPU_QUERY_COUNT] = {false};
+    int gpu_query_next = 0;
+    bool gpu_timing = false;
+    GdkFrameClock *hooked_clock = nullptr;  // referenced while its paint handlers are connected
+    gulong before_paint_handler = 0;
+    gulong after_paint_handler = 0;
+    bool debug_overlay = false;
+    
+    PowerGovernor governor;
+    
+    // Show latency tracing; client stamps arrive with the control request
+    ShowTrace show_trace;
+    KeyTrace key_trace;
+    TraceLog trace_log{control_runtime_path("trace")};
+    gint64 trace_client_start = 0;
+    gint64 trace_sent = 0;
+    gint64 trace_received = 0;
+    gint64 last_render_time = 0;
+    guint governor_timer = 0;
+    
+    AppCatalog catalog;
+    AppIndex app_index;
+    DaemonMetrics metrics;
+    guint metrics_timer = 0;
+    // Icon name -> GdkPixbuf (GTK3) or GtkIconPaintable (GTK4) at icon_size; nullptr if missing
+    std::unordered_map<std::string, GObject*> icon_cache;
+    Spawner spawner;
+    Prefetcher prefetcher;
+    int prefetched_slot = -1;  // top result last handed to the prefetcher
+    std::unique_ptr<KeystrokeRecorder> keystrokes;  // only with record_keystrokes=1
+    std::vector<uint32_t> filtered_apps;  // catalog slots, or stdin line indices with --dmenu
+    std::string current_query;
+    std::vector<GtkWidget*> icon_widgets;
+    int selected_index = 0;
+    int lock_fd;
+    
+    // --dmenu
+    static constexpr size_t DMENU_RESULTS = 120;
+    static constexpr size_t DMENU_BATCH_LINES = 8192;  // per scoring worker
+    static constexpr gint64 DMENU_SLICE_US = 6000;
+    bool dmenu = false;
+    std::unique_ptr<LineStore> dmenu_lines;
+    std::unique_ptr<ThreadPool> scoring_pool;
+    std::unique_ptr<DmenuFilter> dmenu_filter;
+    std::vector<char> dmenu_buffer;
+    guint dmenu_input_watch = 0;
+    guint dmenu_scan_source = 0;
+    uint64_t dmenu_shown_version = 0;
+    gint64 dmenu_refreshed_at = 0;
+    int dmenu_status = 1;  // 0 once an item was printed
+    
+    int control_fd = -1;
+    guint control_watch = 0;
+    guint signal_sources[4] = {0};
+    GMainLoop *main_loop = nullptr;
+    bool is_visible = false;
+    Config config;
+    ConfigWriter config_writer;
+    UsageJournal usage;
+    guint config_save_source = 0;
+    std::thread compaction_thread;  // one-shot snapshot writer, see compact_usage()
+    guint compaction_source = 0;
+    bool compaction_written = false;
+    bool compaction_queued = false;
+    
+    guint stats_timer = 0;  // only runs while visible
+    SystemSampler sampler;
+    std::string stats_text;
+    
+    // Top-processes panel; the sampler thread only runs while it is open
+    ProcessSampler process_sampler;
+    std::vector<ProcessSampler::Row> process_rows;
+    bool process_panel_open = false;
+    bool process_by_memory = false;
+    guint process_timer = 0;
+    pid_t kill_armed_pid = 0;
+    gint64 kill_armed_at = 0;
+    
+    // Power menu overlay
+    bool power_menu_open = false;
+    int power_selected = 0;
+    int power_armed = -1;  // action waiting for confirmation
+    int power_confirm_left = 0;
+    guint power_confirm_timer = 0;
+    guint prewarm_source = 0;
+    bool grid_prewarmed = false;
+    guint fade_tick = 0;
+    gint64 fade_start_time = 0;
+    double fade_from = 0.0;
+    guint morph_timer = 0;
+    gint64 morph_step_start = 0;
+    gint64 morph_paused_elapsed = 0;
+    double current_opacity = 0.0;
+    bool fading_in = false;
+    int morph_current_theme = 0;
+    
+    bool calculator_mode = false;
+    bool web_search_mode = false;
+    bool command_mode = false;
+    
+    static constexpr int LAUNCHER_WIDTH = 500;
+    static constexpr int LAUNCHER_HEIGHT = 600;
+    static constexpr int MARGIN_TOP = 50;
+    static constexpr bool POSITION_TOP_LEFT = true;
+    
+    // Shader initialization
+    void init_shaders() {
+        PROFILE_SCOPE("init_shaders");
+        // Compile vertex shader
+        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vs, 1, &vertex_shader_source, NULL);
+        glCompileShader(vs);
+        
+        // Check vertex shader
+        GLint success;
+        glGetShaderiv(vs, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char log[512];
+            glGetShaderInfoLog(vs, 512, NULL, log);
+            std::cerr << "Vertex shader error: " << log << std::endl;
+        }
+        
+        // Compile fragment shader
+        GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fs, 1, &fragment_shader_source, NULL);
+        glCompileShader(fs);
+        
+        // Check fragment shader
+        glGetShaderiv(fs, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char log[512];
+            glGetShaderInfoLog(fs, 512, NULL, log);
+            std::cerr << "Fragment shader error: " << log << std::endl;
+        }
+        
+        // Link program
+        shader_program = glCreateProgram();
+        glAttachShader(shader_program, vs);
+        glAttachShader(shader_program, fs);
+        glLinkProgram(shader_program);
+        
+        // Check program
+        glGetProgramiv(shader_program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char log[512];
+            glGetProgramInfoLog(shader_program, 512, NULL, log);
+            std::cerr << "Shader program error: " << log << std::endl;
+        }
+        
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        
+        // Create quad
+        float vertices[] = {
+            -1.0f, -1.0f,
+             1.0f, -1.0f,
+            -1.0f,  1.0f,
+             1.0f,  1.0f
+        };
+        
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(0);
+        
+        // GPU timer queries (core since GL 3.3)
+        gpu_timing = epoxy_is_desktop_gl() &&
+            (epoxy_gl_version() >= 33 || epoxy_has_gl_extension("GL_ARB_timer_query"));
+        if (gpu_timing) {
+            glGenQueries(GPU_QUERY_COUNT, gpu_queries);
+        }
+    }
+    
+    // Harvest finished timer queries without stalling the pipeline
+    void collect_gpu_timings() {
+        for (int i = 0; i < GPU_QUERY_COUNT; i++) {
+            if (!gpu_query_pending[i]) continue;
+            
+            GLint available = 0;
+            glGetQueryObjectiv(gpu_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            
+            GLuint64 elapsed_ns = 0;
+            glGetQueryObjectui64v(gpu_queries[i], GL_QUERY_RESULT, &elapsed_ns);
+            frame_stats.gpu_ms.push(elapsed_ns / 1000000.0f);
+            gpu_query_pending[i] = false;
+        }
+    }
+    
+    static void on_gl_realize(GtkGLArea *area, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        gtk_gl_area_make_current(area);
+        
+        if (gtk_gl_area_get_error(area) != NULL) {
+            std::cerr << "GL Area error on realize" << std::endl;
+            return;
+        }
+        
+        launcher->init_shaders();
+    }
+    
+    // GL names belong to this context; a later realize creates a new one
+    static void on_gl_unrealize(GtkGLArea *area, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->hook_frame_clock(nullptr);
+        
+        gtk_gl_area_make_current(area);
+        if (gtk_gl_area_get_error(area) != NULL) return;
+        
+        if (launcher->gpu_timing) {
+            glDeleteQueries(GPU_QUERY_COUNT, launcher->gpu_queries);
+            std::fill(std::begin(launcher->gpu_queries), std::end(launcher->gpu_queries), 0);
+            std::fill(std::begin(launcher->gpu_query_pending), std::end(launcher->gpu_query_pending), false);
+            launcher->gpu_timing = false;
+        }
+        glDeleteBuffers(1, &launcher->vbo);
+        glDeleteVertexArrays(1, &launcher->vao);
+        glDeleteProgram(launcher->shader_program);
+        launcher->vbo = launcher->vao = launcher->shader_program = 0;
+    }
+    
+    // Only one clock feeds frame_stats: a re-realized window or a new clock drops the old handlers
+    void hook_frame_clock(GdkFrameClock *clock) {
+        if (hooked_clock) {
+            g_signal_handler_disconnect(hooked_clock, before_paint_handler);
+            g_signal_handler_disconnect(hooked_clock, after_paint_handler);
+            g_object_unref(hooked_clock);
+            hooked_clock = nullptr;
+        }
+        if (clock) {
+            hooked_clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+            before_paint_handler = g_signal_connect(clock, "before-paint", G_CALLBACK(on_before_paint), this);
+            after_paint_handler = g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), this);
+        }
+    }
+    
+    static gboolean on_gl_render(GtkGLArea *area, GdkGLContext *context, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        PROFILE_SCOPE("on_gl_render");
+        gint64 render_start = g_get_monotonic_time();
+        launcher->show_trace.mark(STAGE_GL_RENDER, render_start);
+        
+        // Only time this frame if the next query slot is free
+        GLuint query = 0;
+        if (launcher->gpu_timing) {
+            launcher->collect_gpu_timings();
+            int slot = launcher->gpu_query_next;
+            if (!launcher->gpu_query_pending[slot]) {
+                query = launcher->gpu_queries[slot];
+                launcher->gpu_query_pending[slot] = true;
+                launcher->gpu_query_next = (slot + 1) % GPU_QUERY_COUNT;
+                glBeginQuery(GL_TIME_ELAPSED, query);
+            }
+        }
+        
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        // Enable blending for transparency
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        
+        glUseProgram(launcher->shader_program);
+        
+        // Calculate time
+        gint64 current_time = g_get_monotonic_time();
+        float time = (current_time - launcher->start_time) / 1000000.0f;
+        
+        // Get resolution (GTK3/4 compatible)
+        int width, height;
+        #if GTK_IS_VERSION_4
+            width = gtk_widget_get_width(GTK_WIDGET(area));
+            height = gtk_widget_get_height(GTK_WIDGET(area));
+        #else
+            GtkAllocation alloc;
+            gtk_widget_get_allocation(GTK_WIDGET(area), &alloc);
+            width = alloc.width;
+            height = alloc.height;
+        #endif
+        
+        glUniform1f(glGetUniformLocation(launcher->shader_program, "time"), time);
+        glUniform2f(glGetUniformLocation(launcher->shader_program, "resolution"), width, height);
+        bool morphing = launcher->config.current_theme == THEME_MORPH;
+        Rgb tint = morphing ? launcher->morph_color(current_time, &ThemeColors::primary) : Rgb();
+        glUniform3f(glGetUniformLocation(launcher->shader_program, "tint"), tint.r, tint.g, tint.b);
+        glUniform1f(glGetUniformLocation(launcher->shader_program, "tint_mix"), morphing ? MORPH_TINT_MIX : 0.0f);
+        
+        glBindVertexArray(launcher->vao);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        
+        glDisable(GL_BLEND);
+        
+        if (query != 0) {
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        launcher->frame_stats.render_ms.push((g_get_monotonic_time() - render_start) / 1000.0f);
+        
+        return TRUE;
+    }
+    
+    static void on_before_paint(GdkFrameClock *clock, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->frame_stats.paint_start = g_get_monotonic_time();
+    }
+    
+    static void on_after_paint(GdkFrameClock *clock, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        FrameStats &stats = launcher->frame_stats;
+        if (stats.paint_start == 0) return;
+        
+        gint64 frame_us = g_get_monotonic_time() - stats.paint_start;
+        stats.frame_ms.push(frame_us / 1000.0f);
+        launcher->metrics.frame_us.add(frame_us);
+        stats.paint_start = 0;
+        stats.frames++;
+        
+        launcher->trace_frame(clock);
+        launcher->trace_key_frame(clock);
+    }
+    
+    // First painted frame after a show, then wait for its presentation time
+    void trace_frame(GdkFrameClock *clock) {
+        if (!show_trace.active || show_trace.stamps[STAGE_FADE_START] == 0) return;
+        
+        gint64 counter = gdk_frame_clock_get_frame_counter(clock);
+        if (show_trace.painted_frame < 0) {
+            show_trace.mark(STAGE_PAINTED);
+            show_trace.painted_frame = counter;
+            return;
+        }
+        
+        GdkFrameTimings *timings = gdk_frame_clock_get_timings(clock, show_trace.painted_frame);
+        if (timings && gdk_frame_timings_get_complete(timings)) {
+            gint64 presented = gdk_frame_timings_get_presentation_time(timings);
+            show_trace.mark(STAGE_PRESENTED, presented > 0 ? presented : g_get_monotonic_time());
+        } else if (counter - show_trace.painted_frame < 10) {
+            return;
+        }
+        show_trace.finish(trace_log, config.show_budget_ms);
+    }
+    
+    // Same for the first frame after an injected keystroke rebuilt the grid
+    void trace_key_frame(GdkFrameClock *clock) {
+        if (!key_trace.active || key_trace.stamps[KEY_LISTED] == 0) return;
+        
+        gint64 counter = gdk_frame_clock_get_frame_counter(clock);
+        if (key_trace.painted_frame < 0) {
+            key_trace.mark(KEY_PAINTED);
+            key_trace.painted_frame = counter;
+            return;
+        }
+        
+        GdkFrameTimings *timings = gdk_frame_clock_get_timings(clock, key_trace.painted_frame);
+        if (timings && gdk_frame_timings_get_complete(timings)) {
+            gint64 presented = gdk_frame_timings_get_presentation_time(timings);
+            key_trace.mark(KEY_PRESENTED, presented > 0 ? presented : g_get_monotonic_time());
+        } else if (counter - key_trace.painted_frame < 10) {
+            return;
+        }
+        key_trace.finish(trace_log);
+    }
+    
+    static gboolean gl_tick_callback(GtkWidget *widget, GdkFrameClock *clock, gpointer data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(data);
+        FrameStats &stats = launcher->frame_stats;
+        
+        if (launcher->hooked_clock != clock) {
+            launcher->hook_frame_clock(clock);
+        }
+        
+        // Count vblanks skipped since the previous tick
+        gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
+        gint64 refresh_interval = 0;
+        gdk_frame_clock_get_refresh_info(clock, frame_time, &refresh_interval, NULL);
+        if (stats.last_frame_time != 0 && launcher->is_visible) {
+            gint64 interval = frame_time - stats.last_frame_time;
+            stats.interval_ms.push(interval / 1000.0f);
+            if (refresh_interval > 0 && interval > refresh_interval * 3 / 2) {
+                stats.missed_vblanks += (interval + refresh_interval / 2) / refresh_interval - 1;
+            }
+        }
+        stats.last_frame_time = frame_time;
+        
+        // Static mode and fades keep showing the last rendered frame
+        if (launcher->governor.mode == RENDER_STATIC || launcher->fade_tick != 0) {
+            return G_SOURCE_CONTINUE;
+        }
+        if (launcher->governor.mode == RENDER_REDUCED &&
+            frame_time - launcher->last_render_time < G_USEC_PER_SEC / launcher->config.reduced_fps) {
+            return G_SOURCE_CONTINUE;
+        }
+        launcher->last_render_time = frame_time;
+        
+        gtk_gl_area_queue_render(GTK_GL_AREA(widget));
+        return G_SOURCE_CONTINUE;
+    }
+    
+    void update_render_mode() {
+        if (!governor.update(config)) return;
+        
+        static const char* mode_names[] = {"full", "reduced", "static"};
+        g_message("Render mode: %s (battery %s %d%%, %.0f°C, cpu pressure %.1f)",
+                  mode_names[governor.mode], governor.on_battery ? "discharging" : "ac",
+                  governor.battery_percent, governor.max_temp_c, governor.cpu_pressure);
+        
+        // Without auto-render, redraws reuse the last frame instead of running the shader
+        apply_auto_render();
+        gtk_gl_area_queue_render(GTK_GL_AREA(gl_area));
+    }
+    
+    static gboolean governor_timer_callback(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->update_render_mode();
+        return G_SOURCE_CONTINUE;
+    }
+    
+    // Samples only while shown; a hidden daemon has no periodic wakeups for it
+    void resume_governor() {
+        if (governor_timer == 0) {
+            governor_timer = g_timeout_add_seconds(5, governor_timer_callback, this);
+        }
+    }
+    
+    void pause_governor() {
+        if (governor_timer != 0) {
+            g_source_remove(governor_timer);
+            governor_timer = 0;
+        }
+    }
+    
+    std::string get_theme_css(Theme theme) {
+        ThemeColors colors = theme_palette[theme];
+        std::ostringstream css;
+        
+        css << R"(
+            window {
+                background: transparent;
+            }
+            
+            scrolledwindow {
+                background: transparent;
+                border: none;
+            }
+            
+            list {
+                background: transparent;
+                border: none;
+            }
+            
+            row {
+                background: transparent;
+                color: rgba(170, 200, 230, 0.95);
+                border: none;
+                padding: 10px;
+                margin: 4px 8px;
+            }
+            
+            row:selected {
+                background: transparent;
+                border: none;
+            }
+            
+            entry {
+                background: rgba(15, 15, 25, 0.85);
+                color: rgba(180, 230, 255, 1.0);
+                border: 2px solid rgba()" << colors.primary << R"(, 0.5);
+                border-radius: 8px;
+                padding: 12px 16px;
+                font-size: 16px;
+                font-weight: bold;
             }
             
             entry:focus {
@@ -709,6 +2026,13 @@ private:
                 padding: 8px;
             }
             
+            #power-panel, #process-panel {
+                background: rgba(3, 3, 8, 0.92);
+                border: 1px solid rgba()" << colors.primary << R"(, 0.8);
+                border-radius: 10px;
+                padding: 20px;
+            }
+            
             #stats-label {
                 color: rgba()" << colors.accent << R"(, 0.9);
                 font-size: 11px;
@@ -751,37 +2075,199 @@ private:
         return css.str();
     }
     
-    void apply_theme() {
-        std::string css = get_theme_css();
-        
-        #if GTK_IS_VERSION_4
-            gtk_css_provider_load_from_string(css_provider, css.c_str());
-        #else
-            gtk_css_provider_load_from_data(css_provider, css.c_str(), -1, NULL);
-        #endif
-        
-        config.save();
+    static void add_style_provider(GtkCssProvider *provider, guint priority) {
+        #if GTK_IS_VERSION_4
+            gtk_style_context_add_provider_for_display(
+                gdk_display_get_default(), GTK_STYLE_PROVIDER(provider), priority);
+        #else
+            gtk_style_context_add_provider_for_screen(
+                gdk_screen_get_default(), GTK_STYLE_PROVIDER(provider), priority);
+        #endif
+    }
+    
+    static void remove_style_provider(GtkCssProvider *provider) {
+        #if GTK_IS_VERSION_4
+            gtk_style_context_remove_provider_for_display(
+                gdk_display_get_default(), GTK_STYLE_PROVIDER(provider));
+        #else
+            gtk_style_context_remove_provider_for_screen(
+                gdk_screen_get_default(), GTK_STYLE_PROVIDER(provider));
+        #endif
+    }
+    
+    static void load_css(GtkCssProvider *provider, const std::string& css) {
+        #if GTK_IS_VERSION_4
+            gtk_css_provider_load_from_string(provider, css.c_str());
+        #else
+            gtk_css_provider_load_from_data(provider, css.c_str(), -1, NULL);
+        #endif
+    }
+    
+    GtkCssProvider* theme_provider(Theme theme) {
+        if (!theme_providers[theme]) {
+            theme_providers[theme] = gtk_css_provider_new();
+            load_css(theme_providers[theme], get_theme_css(theme));
+        }
+        return theme_providers[theme];
+    }
+    
+    void use_provider(GtkCssProvider *provider) {
+        if (provider == active_provider) return;
+        if (active_provider) {
+            remove_style_provider(active_provider);
+        }
+        add_style_provider(provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+        active_provider = provider;
+    }
+    
+    // Swaps in the cached provider; each theme's CSS is parsed at most once
+    void apply_theme() {
+        if (config.current_theme == THEME_MORPH) {
+            use_provider(theme_provider(static_cast<Theme>(morph_current_theme)));
+            if (is_visible) {
+                start_morph();
+            }
+        } else {
+            stop_morph();
+            use_provider(theme_provider(config.current_theme));
+        }
+        if (gl_area) {
+            gtk_widget_queue_draw(gl_area);
+        }
+    }
+    
+    // THEME_MORPH cycles through the other themes. Only the shader tint animates
+    // (a uniform, no styling); widgets switch to the next theme's cached provider
+    // once per completed step, so the tree is restyled every 4 s, never per frame.
+    // The tint is a visible change: the background takes on the morph colors.
+    static constexpr gint64 MORPH_STEP_US = 4 * G_USEC_PER_SEC;
+    static constexpr float MORPH_TINT_MIX = 0.3f;
+    
+    Rgb morph_color(gint64 now, std::string ThemeColors::*field) {
+        double steps = static_cast<double>(now - morph_step_start) / MORPH_STEP_US;
+        float t = static_cast<float>(std::min(1.0, std::max(0.0, steps)));
+        t = t * t * (3.0f - 2.0f * t);
+        Theme from = static_cast<Theme>(morph_current_theme);
+        Theme to = static_cast<Theme>((morph_current_theme + 1) % THEME_MORPH);
+        return Rgb::mix(Rgb::parse(theme_palette[from].*field), Rgb::parse(theme_palette[to].*field), t);
+    }
+    
+    static gboolean morph_callback(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->morph_current_theme = (launcher->morph_current_theme + 1) % THEME_MORPH;
+        launcher->morph_step_start = g_get_monotonic_time();
+        launcher->use_provider(launcher->theme_provider(static_cast<Theme>(launcher->morph_current_theme)));
+        launcher->morph_timer = g_timeout_add(MORPH_STEP_US / 1000, morph_callback, launcher);
+        return G_SOURCE_REMOVE;
+    }
+    
+    // Resumes the current step where pause_morph() left it
+    void start_morph() {
+        if (morph_timer != 0) return;
+        gint64 now = g_get_monotonic_time();
+        morph_step_start = now - morph_paused_elapsed;
+        morph_timer = g_timeout_add((MORPH_STEP_US - morph_paused_elapsed) / 1000, morph_callback, this);
+    }
+    
+    void pause_morph() {
+        if (morph_timer != 0) {
+            g_source_remove(morph_timer);
+            morph_timer = 0;
+            morph_paused_elapsed = std::min(MORPH_STEP_US, g_get_monotonic_time() - morph_step_start);
+        }
+    }
+    
+    void stop_morph() {
+        pause_morph();
+        morph_paused_elapsed = 0;
+    }
+    
+    // Marks config dirty; bursts are serialized once and written off the main thread
+    void save_config() {
+        if (config_save_source != 0) return;
+        config_save_source = g_timeout_add(250, [](gpointer data) -> gboolean {
+            FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(data);
+            launcher->config_save_source = 0;
+            launcher->config_writer.submit(launcher->config.serialize());
+            return G_SOURCE_REMOVE;
+        }, this);
+    }
+    
+    // Only unsaved changes are written: rewriting the startup snapshot would
+    // undo whatever another instance saved in the meantime
+    void flush_config() {
+        if (config_save_source != 0) {
+            g_source_remove(config_save_source);
+            config_save_source = 0;
+            config_writer.submit(config.serialize());
+        }
+        config_writer.stop();
+    }
+    
+    // Serializes the history snapshot here and writes it on a worker; the journal
+    // is swapped from the main loop once the write is done. A request while one
+    // is in flight runs after it, so at most one snapshot is pending.
+    void compact_usage() {
+        if (usage.compaction_pending()) {
+            compaction_queued = true;
+            return;
+        }
+        if (compaction_thread.joinable()) compaction_thread.join();
+        std::string path = usage.snapshot_path();
+        std::string snapshot = usage.begin_compaction();
+        compaction_thread = std::thread([this, path = std::move(path), snapshot = std::move(snapshot)] {
+            compaction_written = Config::write_file_atomic(path, snapshot);
+            compaction_source = g_idle_add(on_compaction_written, this);
+        });
     }
     
+    static gboolean on_compaction_written(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->usage.finish_compaction(launcher->compaction_written);
+        if (launcher->compaction_queued) {
+            launcher->compaction_queued = false;
+            launcher->compact_usage();
+        }
+        return G_SOURCE_REMOVE;
+    }
+    
+    // Exit: waits for a snapshot still being written; a long journal is
+    // compacted on the next start
+    void finish_compaction() {
+        if (!compaction_thread.joinable()) return;
+        compaction_thread.join();
+        if (usage.compaction_pending()) {
+            g_source_remove(compaction_source);
+            usage.finish_compaction(compaction_written);
+        }
+    }
+    
+    static constexpr size_t SPARKLINE_WIDTH = 20;
+    
     void update_stats() {
-        struct sysinfo info;
-        if (sysinfo(&info) != 0) return;
-        
-        double load = info.loads[0] / 65536.0;
-        long total_ram = info.totalram / (1024 * 1024);
-        long free_ram = info.freeram / (1024 * 1024);
-        long used_ram = total_ram - free_ram;
+        sampler.sample();
         
         time_t now = time(NULL);
         struct tm *tm_info = localtime(&now);
         char time_str[32];
         strftime(time_str, sizeof(time_str), "%H:%M:%S", tm_info);
         
-        std::ostringstream stats;
-        stats << time_str << "  |  CPU: " << std::fixed << std::setprecision(2) << load 
-              << "  |  RAM: " << used_ram << "/" << total_ram << " MB";
+        // Reuses one buffer; this runs every second while visible
+        char field[96];
+        stats_text.clear();
+        snprintf(field, sizeof(field), "%s  |  CPU: %3.0f%% ", time_str, sampler.cpu_percent);
+        stats_text += field;
+        SystemSampler::append_sparkline(stats_text, sampler.cpu_history, SPARKLINE_WIDTH);
+        snprintf(field, sizeof(field), "  |  RAM: %ld/%ld MB ",
+                 sampler.mem_total_mb - sampler.mem_available_mb, sampler.mem_total_mb);
+        stats_text += field;
+        SystemSampler::append_sparkline(stats_text, sampler.mem_history, SPARKLINE_WIDTH);
+        
+        gtk_label_set_text(GTK_LABEL(stats_label), stats_text.c_str());
         
-        gtk_label_set_text(GTK_LABEL(stats_label), stats.str().c_str());
+        if (debug_overlay) {
+            gtk_label_set_text(GTK_LABEL(debug_label), frame_stats.overlay_text().c_str());
+        }
     }
     
     static gboolean stats_timer_callback(gpointer user_data) {
@@ -790,438 +2276,1223 @@ private:
         return G_SOURCE_CONTINUE;
     }
     
-    static gboolean fade_timer_callback(gpointer user_data) {
+    // One sample covers the whole hidden period, then the 1 s timer takes over
+    void resume_stats() {
+        update_stats();
+        if (stats_timer == 0) {
+            stats_timer = g_timeout_add_seconds(1, stats_timer_callback, this);
+        }
+    }
+    
+    void pause_stats() {
+        if (stats_timer != 0) {
+            g_source_remove(stats_timer);
+            stats_timer = 0;
+        }
+    }
+    
+    static constexpr gint64 FADE_DURATION_US = 150000;
+    
+    // Driven by the frame clock, so steps land on vblank at any refresh rate
+    static gboolean fade_tick_callback(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
         FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
         
-        if (launcher->fading_in) {
-            launcher->current_opacity += 0.05;
-            if (launcher->current_opacity >= 1.0) {
-                launcher->current_opacity = 1.0;
-                launcher->fade_timer = 0;
-                return G_SOURCE_REMOVE;
-            }
-        } else {
-            launcher->current_opacity -= 0.05;
-            if (launcher->current_opacity <= 0.0) {
-                launcher->current_opacity = 0.0;
-                gtk_widget_set_visible(launcher->window, FALSE);
-                launcher->fade_timer = 0;
-                return G_SOURCE_REMOVE;
-            }
+        if (launcher->fade_start_time == 0) {
+            launcher->fade_start_time = frame_time;
         }
         
+        double t = std::min(1.0, (frame_time - launcher->fade_start_time) / (double)FADE_DURATION_US);
+        double eased = 1.0 - std::pow(1.0 - t, 3.0);
+        double target = launcher->fading_in ? 1.0 : 0.0;
+        launcher->current_opacity = launcher->fade_from + (target - launcher->fade_from) * eased;
         gtk_widget_set_opacity(launcher->window, launcher->current_opacity);
-        return G_SOURCE_CONTINUE;
+        
+        if (t < 1.0) {
+            return G_SOURCE_CONTINUE;
+        }
+        
+        launcher->fade_tick = 0;
+        launcher->finish_fade();
+        return G_SOURCE_REMOVE;
+    }
+    
+    void finish_fade() {
+        if (!fading_in) {
+            gtk_widget_set_visible(window, FALSE);
+            on_hidden();
+        }
+        apply_auto_render();
+    }
+    
+    // During a fade the last shader frame is composited at the new opacity instead of re-rendered
+    void apply_auto_render() {
+        gtk_gl_area_set_auto_render(GTK_GL_AREA(gl_area), fade_tick == 0 && governor.mode != RENDER_STATIC);
     }
     
     void start_fade(bool fade_in) {
-        if (fade_timer != 0) {
-            g_source_remove(fade_timer);
+        if (fade_tick != 0) {
+            gtk_widget_remove_tick_callback(window, fade_tick);
+            fade_tick = 0;
         }
         
         fading_in = fade_in;
+        fade_start_time = 0;
         
         if (fade_in) {
             current_opacity = 0.0;
             gtk_widget_set_opacity(window, 0.0);
             gtk_widget_set_visible(window, TRUE);
+            
+            // One fresh frame to composite for the duration of the fade
+            gtk_gl_area_queue_render(GTK_GL_AREA(gl_area));
+        } else if (!gtk_widget_get_mapped(window)) {
+            current_opacity = 0.0;
+            finish_fade();
+            return;
         }
         
-        fade_timer = g_timeout_add(16, fade_timer_callback, this);
+        fade_from = current_opacity;
+        fade_tick = gtk_widget_add_tick_callback(window, fade_tick_callback, this, NULL);
+        apply_auto_render();
     }
     
-    double calculate_expression(const std::string& expr) {
-        try {
-            std::string clean_expr = expr;
-            clean_expr.erase(std::remove(clean_expr.begin(), clean_expr.end(), ' '), clean_expr.end());
-            
-            std::string cmd = "echo '" + clean_expr + "' | bc -l 2>/dev/null";
-            FILE* pipe = popen(cmd.c_str(), "r");
-            if (!pipe) return NAN;
-            
-            char buffer[128];
-            std::string result;
-            while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
-                result += buffer;
-            }
-            pclose(pipe);
-            
-            if (result.empty()) return NAN;
-            return std::stod(result);
-            
-        } catch (...) {
-            return NAN;
-        }
-    }
-
 public:
-    FuturisticLauncher() {
+    // Only the process that holds the lock (the daemon) constructs a launcher
+    // A --dmenu launcher (lock -1) lists stdin lines instead of the app catalog
+    explicit FuturisticLauncher(int lock, bool dmenu_mode = false) : lock_fd(lock) {
         config.load();
-        load_applications();
+        usage.set_half_life_days(config.frecency_half_life_days);
+        prefetcher.set_budget_mb(config.prefetch_budget_mb);
+        dmenu = dmenu_mode;
+        if (dmenu) {
+            dmenu_lines = std::make_unique<LineStore>(static_cast<size_t>(config.dmenu_max_mb) << 20);
+            scoring_pool = std::make_unique<ThreadPool>(config.scoring_threads);
+            dmenu_filter = std::make_unique<DmenuFilter>(*dmenu_lines, DMENU_RESULTS, scoring_pool.get());
+        } else {
+            usage.load(std::string(g_get_user_data_dir()) + "/futuristic-launcher", config);
+            if (usage.needs_compaction()) {
+                compact_usage();
+            }
+            if (config.record_keystrokes) {
+                keystrokes = std::make_unique<KeystrokeRecorder>(
+                    std::string(g_get_user_data_dir()) + "/futuristic-launcher/keystrokes.log");
+            }
+            load_applications();
+        }
         start_time = g_get_monotonic_time();
+        
+        if (const char *root = g_getenv("FUTURISTIC_LAUNCHER_SYSFS_ROOT")) governor.sysfs_root = root;
+        if (const char *root = g_getenv("FUTURISTIC_LAUNCHER_PROCFS_ROOT")) governor.procfs_root = root;
     }
     
     ~FuturisticLauncher() {
+        for (guint source : signal_sources) {
+            if (source != 0) g_source_remove(source);
+        }
+        if (control_watch != 0) {
+            g_source_remove(control_watch);
+        }
+        if (control_fd >= 0) {
+            close(control_fd);
+            unlink(control_runtime_path("sock").c_str());
+        }
         if (lock_fd >= 0) {
             close(lock_fd);
-            unlink("/tmp/futuristic-launcher.lock");
         }
         if (stats_timer != 0) {
             g_source_remove(stats_timer);
         }
-        if (fade_timer != 0) {
-            g_source_remove(fade_timer);
+        if (fade_tick != 0) {
+            gtk_widget_remove_tick_callback(window, fade_tick);
         }
         if (morph_timer != 0) {
             g_source_remove(morph_timer);
         }
-        config.save();
+        for (GtkCssProvider *provider : theme_providers) {
+            if (provider) g_object_unref(provider);
+        }
+        if (governor_timer != 0) {
+            g_source_remove(governor_timer);
+        }
+        if (prewarm_source != 0) {
+            g_source_remove(prewarm_source);
+        }
+        if (power_confirm_timer != 0) {
+            g_source_remove(power_confirm_timer);
+        }
+        if (process_timer != 0) {
+            g_source_remove(process_timer);
+        }
+        if (metrics_timer != 0) {
+            g_source_remove(metrics_timer);
+            unlink(control_runtime_path("prom").c_str());
+        }
+        if (dmenu_input_watch != 0) {
+            g_source_remove(dmenu_input_watch);
+        }
+        if (dmenu_scan_source != 0) {
+            g_source_remove(dmenu_scan_source);
+        }
+        hook_frame_clock(nullptr);
+        clear_icon_cache();
+        // stderr may belong to a calling script (--dmenu); SIGUSR2 dumps on demand
+        if (debug_overlay) {
+            frame_stats.dump(std::cerr);
+            show_trace.dump(std::cerr);
+            key_trace.dump(std::cerr);
+        }
+        trace_log.flush();
+        finish_compaction();
+        // A --dmenu run never owns the config; the daemon does
+        if (!dmenu) {
+            flush_config();
+        }
     }
     
-    bool try_acquire_lock() {
-        lock_fd = open("/tmp/futuristic-launcher.lock", O_CREAT | O_RDWR, 0666);
-        if (lock_fd < 0) return false;
+    // Daemon side: non-blocking listener driven by the GLib main loop
+    struct ControlClient {
+        FuturisticLauncher *launcher;
+        int fd;
+        std::string buffer;
+    };
+    
+    static constexpr size_t CONTROL_MAX_LINE = 4096;
+    
+    bool start_control_server() {
+        std::string path = control_runtime_path("sock");
         
-        if (flock(lock_fd, LOCK_EX | LOCK_NB) < 0) {
-            close(lock_fd);
-            lock_fd = -1;
+        // We hold the lock, so any existing socket is stale
+        unlink(path.c_str());
+        
+        control_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (control_fd < 0) return false;
+        
+        struct sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        
+        mode_t old_mask = umask(0077);
+        int bound = bind(control_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        umask(old_mask);
+        
+        if (bound < 0 || listen(control_fd, 16) < 0) {
+            std::cerr << "Control socket error: " << strerror(errno) << std::endl;
+            close(control_fd);
+            control_fd = -1;
             return false;
         }
+        
+        control_watch = g_unix_fd_add(control_fd, G_IO_IN, on_control_accept, this);
         return true;
     }
     
-    static void signal_toggle() {
-        std::ifstream pid_file("/tmp/futuristic-launcher.pid");
-        if (pid_file.is_open()) {
-            pid_t pid;
-            pid_file >> pid;
-            pid_file.close();
-            kill(pid, SIGUSR1);
-        }
+    static gboolean on_control_accept(gint fd, GIOCondition condition, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        
+        while (true) {
+            int client_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client_fd < 0) break;
+            
+            ControlClient *client = new ControlClient{launcher, client_fd, ""};
+            g_unix_fd_add_full(G_PRIORITY_DEFAULT, client_fd,
+                               (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR),
+                               on_control_readable, client,
+                               [](gpointer data) {
+                                   ControlClient *c = static_cast<ControlClient*>(data);
+                                   close(c->fd);
+                                   delete c;
+                               });
+        }
+        return G_SOURCE_CONTINUE;
+    }
+    
+    static gboolean on_control_readable(gint fd, GIOCondition condition, gpointer user_data) {
+        ControlClient *client = static_cast<ControlClient*>(user_data);
+        char buf[1024];
+        
+        while (true) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n > 0) {
+                client->buffer.append(buf, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            
+            // EOF or error: answer what is complete, then drop the client
+            client->launcher->process_control_buffer(client);
+            return G_SOURCE_REMOVE;
+        }
+        
+        if (!client->launcher->process_control_buffer(client)) {
+            return G_SOURCE_REMOVE;
+        }
+        return G_SOURCE_CONTINUE;
+    }
+    
+    bool process_control_buffer(ControlClient *client) {
+        size_t newline;
+        while ((newline = client->buffer.find('\n')) != std::string::npos) {
+            std::string line = client->buffer.substr(0, newline);
+            client->buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            
+            // Replies are small; a client that stops reading is dropped
+            if (!control_write_all(client->fd, handle_control_command(line))) {
+                return false;
+            }
+        }
+        return client->buffer.size() <= CONTROL_MAX_LINE;
+    }
+    
+    // Line protocol: one command per line, every reply ends with "ok" or "error <reason>"
+    std::string handle_control_command(const std::string& request) {
+        // Optional trailing "\t<client start>,<sent>" monotonic stamps from the client
+        std::string line = request;
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos) {
+            trace_received = g_get_monotonic_time();
+            sscanf(line.c_str() + tab + 1, "%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT,
+                   &trace_client_start, &trace_sent);
+            line.erase(tab);
+        }
+        
+        std::string command = line;
+        std::string arg;
+        size_t space = line.find(' ');
+        if (space != std::string::npos) {
+            command = line.substr(0, space);
+            arg = line.substr(space + 1);
+        }
+        
+        std::string reply = run_control_command(command, arg);
+        trace_client_start = trace_sent = trace_received = 0;
+        return reply;
+    }
+    
+    std::string run_control_command(const std::string& command, const std::string& arg) {
+        if (command == "toggle") {
+            toggle_visibility();
+        } else if (command == "show") {
+            if (!is_visible) toggle_visibility();
+        } else if (command == "hide") {
+            if (is_visible) toggle_visibility();
+        } else if (command == "query" || command == "calc") {
+            show_with_query(arg);
+        } else if (command == "command") {
+            show_with_query(">" + arg);
+        } else if (command == "key") {
+            if (!is_visible) return "error launcher is hidden\n";
+            inject_key(arg);
+        } else if (command == "reload") {
+            reload_applications();
+        } else if (command == "stats") {
+            return stats_report() + "ok\n";
+        } else if (command == "metrics") {
+            return metrics_text() + "ok\n";
+        } else if (command == "ping") {
+            // Latency probe, no side effects
+        } else {
+            return "error unknown command '" + command + "'\n";
+        }
+        return "ok\n";
+    }
+    
+    void show_with_query(const std::string& text) {
+        if (!is_visible) toggle_visibility();
+        if (text == current_query) return;
+        
+        #if GTK_IS_VERSION_4
+            gtk_editable_set_text(GTK_EDITABLE(search_entry), text.c_str());
+        #else
+            gtk_entry_set_text(GTK_ENTRY(search_entry), text.c_str());
+        #endif
+        gtk_editable_set_position(GTK_EDITABLE(search_entry), -1);
+        filter_apps(text);
+        update_list();
+        grid_prewarmed = false;
+    }
+    
+    // Edits the entry the way a key press would, then runs search-changed right
+    // away instead of after the entry's delay (the UI latency harness types this way)
+    void inject_key(const std::string& key) {
+        key_trace.begin(trace_received ? trace_received : g_get_monotonic_time());
+        
+        GtkEditable *editable = GTK_EDITABLE(search_entry);
+        int position = gtk_editable_get_position(editable);
+        if (key == "BackSpace") {
+            if (position > 0) gtk_editable_delete_text(editable, position - 1, position);
+        } else {
+            gtk_editable_insert_text(editable, key.c_str(), -1, &position);
+            gtk_editable_set_position(editable, position);
+        }
+        g_signal_emit_by_name(search_entry, "search-changed");
+        
+        // Unchanged query: nothing gets redrawn for it
+        if (key_trace.stamps[KEY_LISTED] == 0) key_trace.active = false;
+    }
+    
+    // update_list() rebuilds the grid on every keystroke; each icon is only looked up and decoded once
+    GtkWidget* new_icon_image(std::string_view name) {
+        GObject *image = nullptr;
+        if (!name.empty()) {
+            auto it = icon_cache.find(std::string(name));
+            if (it != icon_cache.end()) {
+                metrics.icon_hits.add();
+                image = it->second;
+            } else {
+                PROFILE_SCOPE("icon_load");
+                metrics.icon_misses.add();
+                std::string icon_name(name);
+                GtkIconTheme *icon_theme = gtk_icon_theme_get_default();
+                #if GTK_IS_VERSION_4
+                    GtkIconPaintable *icon_paintable = gtk_icon_theme_lookup_icon(
+                        icon_theme, icon_name.c_str(), NULL, config.icon_size, 1,
+                        GTK_TEXT_DIR_NONE, GTK_ICON_LOOKUP_FORCE_REGULAR);
+                    image = icon_paintable ? G_OBJECT(icon_paintable) : nullptr;
+                #else
+                    GdkPixbuf *pixbuf = gtk_icon_theme_load_icon(icon_theme, icon_name.c_str(),
+                                                                  config.icon_size, GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
+                    image = pixbuf ? G_OBJECT(pixbuf) : nullptr;
+                #endif
+                icon_cache.emplace(std::move(icon_name), image);
+            }
+        }
+        
+        #if GTK_IS_VERSION_4
+            if (image) return gtk_image_new_from_paintable(GDK_PAINTABLE(image));
+            return gtk_image_new_from_icon_name("application-x-executable");
+        #else
+            if (image) return gtk_image_new_from_pixbuf(GDK_PIXBUF(image));
+            return gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
+        #endif
+    }
+    
+    void clear_icon_cache() {
+        for (auto& [name, image] : icon_cache) {
+            if (image) g_object_unref(image);
+        }
+        icon_cache.clear();
+    }
+    
+    // stdin is drained at low priority in bounded slices, so typing stays ahead of a
+    // fast producer; the window is usable while `find /` is still writing
+    void start_dmenu() {
+        fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+        dmenu_buffer.resize(64 << 10);
+        dmenu_input_watch = g_unix_fd_add_full(G_PRIORITY_LOW, STDIN_FILENO,
+                                               (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                               on_dmenu_input, this, NULL);
+        update_dmenu_status(false);
+    }
+    
+    int dmenu_exit_status() const { return dmenu_status; }
+    
+    static gboolean on_dmenu_input(gint fd, GIOCondition condition, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        gint64 start = g_get_monotonic_time();
+        bool eof = false;
+        while (g_get_monotonic_time() - start < DMENU_SLICE_US) {
+            ssize_t n = read(fd, launcher->dmenu_buffer.data(), launcher->dmenu_buffer.size());
+            if (n > 0) {
+                launcher->dmenu_lines->append(launcher->dmenu_buffer.data(), n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                // EAGAIN waits for the next wakeup; EOF and errors end the input
+                eof = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                break;
+            }
+        }
+        
+        if (eof) {
+            launcher->dmenu_lines->finish();
+            launcher->dmenu_input_watch = 0;
+        }
+        launcher->update_dmenu_status(eof);
+        launcher->schedule_dmenu_scan();
+        return eof ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+    }
+    
+    void update_dmenu_status(bool eof) {
+        std::string text = std::to_string(dmenu_lines->size()) + (eof ? " items" : " items, reading…");
+        if (dmenu_lines->dropped_lines() > 0) {
+            text += " (" + std::to_string(dmenu_lines->dropped_lines()) + " over dmenu_max_mb dropped)";
+        }
+        g_object_set(search_entry, "placeholder-text", text.c_str(), NULL);
+    }
+    
+    void schedule_dmenu_scan() {
+        if (dmenu_scan_source == 0 && !dmenu_filter->done()) {
+            dmenu_scan_source = g_idle_add_full(G_PRIORITY_LOW, on_dmenu_scan, this, NULL);
+        }
+    }
+    
+    // Scores lines that arrived since the last slice, or the rest of the input after a query change
+    static gboolean on_dmenu_scan(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        bool done = launcher->scan_dmenu();
+        launcher->refresh_dmenu_grid(done);
+        if (done) {
+            launcher->dmenu_scan_source = 0;
+            return G_SOURCE_REMOVE;
+        }
+        return G_SOURCE_CONTINUE;
+    }
+    
+    bool scan_dmenu() {
+        gint64 start = g_get_monotonic_time();
+        bool done;
+        // With two or more workers a batch is past the filter's single-threaded cut-over
+        do {
+            done = dmenu_filter->advance(DMENU_BATCH_LINES * scoring_pool->size());
+        } while (!done && g_get_monotonic_time() - start < DMENU_SLICE_US);
+        return done;
+    }
+    
+    // Rebuilding the grid costs more than a slice of scoring, so results that are still
+    // streaming in reach the screen at most every 100 ms
+    void refresh_dmenu_grid(bool force) {
+        if (dmenu_filter->version() == dmenu_shown_version) return;
+        gint64 now = g_get_monotonic_time();
+        if (!force && now - dmenu_refreshed_at < 100000) return;
+        
+        int selected = selected_index;
+        dmenu_filter->results(filtered_apps);
+        dmenu_shown_version = dmenu_filter->version();
+        dmenu_refreshed_at = now;
+        update_list();
+        selected_index = std::max(0, std::min(selected, (int)filtered_apps.size() - 1));
+        update_selection();
+    }
+    
+    // The first slice answers the keystroke; the rest continues in the background
+    QueryMode filter_dmenu(const std::string& search_text) {
+        dmenu_filter->set_query(search_text);
+        scan_dmenu();
+        dmenu_filter->results(filtered_apps);
+        dmenu_shown_version = dmenu_filter->version();
+        dmenu_refreshed_at = g_get_monotonic_time();
+        schedule_dmenu_scan();
+        return QUERY_APPS;
+    }
+    
+    void finish_dmenu(std::string_view item) {
+        std::cout << item << std::endl;
+        dmenu_status = 0;
+        quit();
+    }
+    
+    static std::string valid_utf8(std::string_view text) {
+        gchar *valid = g_utf8_make_valid(text.data(), text.size());
+        std::string result(valid);
+        g_free(valid);
+        return result;
+    }
+    
+    void reload_applications() {
+        clear_icon_cache();
+        catalog.clear();
+        load_applications();
+        
+        const char *text = gtk_editable_get_text(GTK_EDITABLE(search_entry));
+        filter_apps(text);
+        update_list();
+        invalidate_grid();
+    }
+    
+    std::string stats_report() {
+        static const char* mode_names[] = {"full", "reduced", "static"};
+        std::ostringstream out;
+        out << "pid=" << getpid() << "\n"
+            << "gtk=" << GTK_MAJOR_VERSION << "\n"
+            << "uptime_s=" << (g_get_monotonic_time() - start_time) / G_USEC_PER_SEC << "\n"
+            << "visible=" << (is_visible ? 1 : 0) << "\n"
+            << "apps=" << catalog.size() << "\n"
+            << "catalog_bytes=" << catalog.memory_bytes() << "\n"
+            << "filtered=" << filtered_apps.size() << "\n"
+            << "render_mode=" << mode_names[governor.mode] << "\n"
+            << "frames=" << frame_stats.frames << "\n"
+            << "missed_vblanks=" << frame_stats.missed_vblanks << "\n"
+            << std::fixed << std::setprecision(2)
+            << "frame_p95_ms=" << frame_stats.frame_ms.percentile(95) << "\n"
+            << "gpu_p95_ms=" << frame_stats.gpu_ms.percentile(95) << "\n"
+            << "show_p50_us=" << show_trace.total_hist.percentile(50) << "\n"
+            << "show_p95_us=" << show_trace.total_hist.percentile(95) << "\n"
+            << "show_over_budget=" << show_trace.over_budget << "\n"
+            << "key_p50_us=" << key_trace.total_hist.percentile(50) << "\n"
+            << "key_p95_us=" << key_trace.total_hist.percentile(95) << "\n"
+            << "searches=" << metrics.searches.get() << "\n"
+            << "search_p50_us=" << metrics.search_us.percentile(50) << "\n"
+            << "search_p95_us=" << metrics.search_us.percentile(95) << "\n"
+            << "list_tiles=" << icon_widgets.size() << "\n"
+            << "icon_hit_pct=" << icon_hit_pct() << "\n"
+            << "rss_kb=" << resident_bytes() / 1024 << "\n"
+            << "launches=" << metrics.launches.get() << "\n"
+            << "spawned=" << spawner.spawned.get() << "\n"
+            << "spawn_failures=" << spawner.failures.get() << "\n"
+            << "spawn_p50_us=" << spawner.exec_hist.percentile(50) << "\n"
+            << "spawn_p95_us=" << spawner.exec_hist.percentile(95) << "\n";
+        
+        Prefetcher::Stats prefetch = prefetcher.snapshot();
+        out << "prefetch_files=" << prefetch.files << "\n"
+            << "prefetch_bytes=" << prefetch.bytes << "\n"
+            << "prefetch_over_budget=" << prefetch.over_budget << "\n"
+            << "prefetch_resident_pct="
+            << (prefetch.pages ? 100.0 * prefetch.resident_pages / prefetch.pages : 0.0) << "\n"
+            << "prefetch_launch_hit_pct="
+            << (prefetch.launches ? 100.0 * prefetch.launch_hits / prefetch.launches : 0.0) << "\n";
+        return out.str();
+    }
+    
+    double icon_hit_pct() const {
+        uint64_t hits = metrics.icon_hits.get();
+        uint64_t lookups = hits + metrics.icon_misses.get();
+        return lookups ? 100.0 * hits / lookups : 0.0;
+    }
+    
+    // Second field of /proc/self/statm, in pages
+    static uint64_t resident_bytes() {
+        unsigned long size = 0, resident = 0;
+        FILE *statm = fopen("/proc/self/statm", "re");
+        if (!statm) return 0;
+        if (fscanf(statm, "%lu %lu", &size, &resident) != 2) resident = 0;
+        fclose(statm);
+        return static_cast<uint64_t>(resident) * sysconf(_SC_PAGESIZE);
+    }
+    
+    std::string metrics_text() {
+        PrometheusText out("futuristic_launcher_");
+        out.gauge("uptime_seconds", "Seconds since the daemon started",
+                  (g_get_monotonic_time() - start_time) / static_cast<double>(G_USEC_PER_SEC));
+        out.gauge("visible", "1 while the launcher is shown", is_visible ? 1 : 0);
+        out.gauge("resident_memory_bytes", "Resident set size", resident_bytes());
+        out.gauge("apps", "Apps in the catalog", catalog.size());
+        out.counter("searches_total", "Queries run through search()", metrics.searches.get());
+        out.histogram("search_duration_seconds", "Time spent in search() per query", metrics.search_us);
+        out.counter("list_rebuilds_total", "Result grid rebuilds", metrics.list_rebuilds.get());
+        out.counter("list_tiles_total", "App tiles created by grid rebuilds", metrics.list_tiles.get());
+        out.gauge("list_tiles", "App tiles in the current grid", icon_widgets.size());
+        out.counter("icon_cache_hits_total", "Grid icons served from the icon cache", metrics.icon_hits.get());
+        out.counter("icon_cache_misses_total", "Grid icons looked up in the icon theme", metrics.icon_misses.get());
+        out.gauge("icon_cache_entries", "Icons held by the icon cache", icon_cache.size());
+        out.counter("launches_total", "Apps launched from the grid", metrics.launches.get());
+        out.counter("spawns_total", "Processes spawned, including web searches, commands and power actions",
+                    spawner.spawned.get());
+        out.counter("spawn_failures_total", "Processes that failed to spawn", spawner.failures.get());
+        out.histogram("spawn_duration_seconds", "posix_spawn() until the child exec'd", spawner.exec_hist);
+        out.histogram("frame_duration_seconds", "Frame clock before-paint to after-paint", metrics.frame_us);
+        out.counter("missed_vblanks_total", "Vblanks skipped by the frame clock", frame_stats.missed_vblanks);
+        out.histogram("show_duration_seconds", "Show request to first presented frame", show_trace.total_hist);
+        return out.str();
+    }
+    
+    // $XDG_RUNTIME_DIR/futuristic-launcher.prom for node_exporter's textfile collector
+    void write_metrics_file() {
+        if (!Config::write_file_atomic(control_runtime_path("prom"), metrics_text())) {
+            std::cerr << "Failed to write " << control_runtime_path("prom") << std::endl;
+        }
+    }
+    
+    static gboolean metrics_timer_callback(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->write_metrics_file();
+        return G_SOURCE_CONTINUE;
+    }
+    
+    void toggle_visibility() {
+        if (is_visible) {
+            close_power_menu();
+            if (process_panel_open) {
+                toggle_process_panel();
+            }
+            pause_stats();
+            pause_governor();
+            pause_morph();
+            trace_log.flush();
+            if (keystrokes) {
+                keystrokes->dismiss(g_get_monotonic_time());
+            }
+            start_fade(false);
+            is_visible = false;
+        } else {
+            show_trace.begin(trace_client_start, trace_sent,
+                             trace_received ? trace_received : g_get_monotonic_time());
+            trace_client_start = trace_sent = trace_received = 0;
+            
+            if (keystrokes) {
+                keystrokes->begin(g_get_monotonic_time());
+            }
+            start_fade(true);
+            show_trace.mark(STAGE_FADE_START);
+            gtk_widget_grab_focus(search_entry);
+            
+            // Normally the empty-query grid was built while hidden
+            if (!grid_prewarmed) {
+                prewarm_grid();
+            }
+            show_trace.mark(STAGE_FILTERED);
+            selected_index = 0;
+            update_selection();
+            show_trace.mark(STAGE_LISTED);
+            is_visible = true;
+            resume_stats();
+            resume_governor();
+            if (config.current_theme == THEME_MORPH) {
+                start_morph();
+            }
+            prefetch_likely_apps();
+        }
+    }
+    
+    // Top apps by frecency, warmed while the user is still typing
+    void prefetch_likely_apps() {
+        if (config.prefetch_apps == 0 || catalog.empty()) return;
+        
+        std::vector<uint32_t> slots(catalog.size());
+        for (uint32_t slot = 0; slot < slots.size(); slot++) slots[slot] = slot;
+        size_t count = std::min<size_t>(config.prefetch_apps, slots.size());
+        std::partial_sort(slots.begin(), slots.begin() + count, slots.end(),
+            [this](uint32_t a, uint32_t b) { return catalog.frecency[a] > catalog.frecency[b]; });
+        
+        std::vector<std::string> commands;
+        for (size_t i = 0; i < count && catalog.frecency[slots[i]] > 0.0; i++) {
+            commands.emplace_back(catalog.command(slots[i]));
+        }
+        prefetcher.request(std::move(commands));
+        prefetched_slot = -1;
+    }
+    
+    // Builds the empty-query grid so the next show is just a map and fade
+    void prewarm_grid() {
+        if (prewarm_source != 0) {
+            g_source_remove(prewarm_source);
+            prewarm_source = 0;
+        }
+        
+        const char *text = gtk_editable_get_text(GTK_EDITABLE(search_entry));
+        if (text[0] != '\0') {
+            #if GTK_IS_VERSION_4
+                gtk_editable_set_text(GTK_EDITABLE(search_entry), "");
+            #else
+                gtk_entry_set_text(GTK_ENTRY(search_entry), "");
+            #endif
+        }
+        filter_apps("");
+        update_list();
+        grid_prewarmed = true;
+    }
+    
+    static gboolean prewarm_idle(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->prewarm_source = 0;
+        if (!launcher->is_visible) {
+            launcher->prewarm_grid();
+        }
+        return G_SOURCE_REMOVE;
+    }
+    
+    void schedule_prewarm() {
+        if (grid_prewarmed || prewarm_source != 0) return;
+        prewarm_source = g_idle_add_full(G_PRIORITY_LOW, prewarm_idle, this, NULL);
+    }
+    
+    // Catalog or ranking changed; rebuild in idle time once hidden
+    void invalidate_grid() {
+        grid_prewarmed = false;
+        if (!is_visible) schedule_prewarm();
+    }
+    
+    void on_hidden() {
+        schedule_prewarm();
+    }
+    
+    // Signals are dispatched from the main loop by GLib, never from handler context
+    void install_signal_handlers() {
+        signal_sources[0] = g_unix_signal_add(SIGUSR1, on_toggle_signal, this);
+        signal_sources[1] = g_unix_signal_add(SIGUSR2, on_dump_signal, this);
+        signal_sources[2] = g_unix_signal_add(SIGTERM, on_terminate_signal, this);
+        signal_sources[3] = g_unix_signal_add(SIGINT, on_terminate_signal, this);
+    }
+    
+    static gboolean on_toggle_signal(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->toggle_visibility();
+        return G_SOURCE_CONTINUE;
     }
     
-    void save_pid() {
-        std::ofstream pid_file("/tmp/futuristic-launcher.pid");
-        pid_file << getpid();
-        pid_file.close();
+    static gboolean on_dump_signal(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->frame_stats.dump(std::cerr);
+        launcher->show_trace.dump(std::cerr);
+        launcher->key_trace.dump(std::cerr);
+        return G_SOURCE_CONTINUE;
     }
     
-    void toggle_visibility() {
-        if (is_visible) {
-            start_fade(false);
-            is_visible = false;
-        } else {
-            start_fade(true);
-            gtk_widget_grab_focus(search_entry);
-            #if GTK_IS_VERSION_4
-                gtk_editable_set_text(GTK_EDITABLE(search_entry), "");
-            #else
-                gtk_entry_set_text(GTK_ENTRY(search_entry), "");
-            #endif
-            filter_apps("");
-            update_list();
-            is_visible = true;
-        }
+    static gboolean on_terminate_signal(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->quit();
+        return G_SOURCE_CONTINUE;
     }
     
-    static void handle_signal(int sig) {
-        if (sig == SIGUSR1) {
-            g_idle_add([](gpointer data) -> gboolean {
-                FuturisticLauncher* launcher = static_cast<FuturisticLauncher*>(data);
-                launcher->toggle_visibility();
-                return G_SOURCE_REMOVE;
-            }, g_launcher_instance);
-        }
+    void run_main_loop() {
+        #if GTK_IS_VERSION_4
+            main_loop = g_main_loop_new(NULL, FALSE);
+            g_main_loop_run(main_loop);
+            g_main_loop_unref(main_loop);
+            main_loop = nullptr;
+        #else
+            gtk_main();
+        #endif
     }
     
-    static FuturisticLauncher* g_launcher_instance;
-
-    void load_applications() {
-        std::vector<std::string> app_dirs = {
-            "/usr/share/applications",
-            "/usr/local/share/applications",
-            std::string(g_get_home_dir()) + "/.local/share/applications"
-        };
+    // Leaves the main loop; the destructor then flushes config and stats
+    void quit() {
+        #if GTK_IS_VERSION_4
+            if (main_loop) g_main_loop_quit(main_loop);
+        #else
+            gtk_main_quit();
+        #endif
+    }
 
-        for (const auto& dir : app_dirs) {
-            if (!fs::exists(dir)) continue;
-            
-            for (const auto& entry : fs::directory_iterator(dir)) {
-                if (entry.path().extension() == ".desktop") {
-                    DesktopApp app = parse_desktop_file(entry.path().string());
-                    if (!app.name.empty() && !app.no_display) {
-                        if (config.launch_counts.count(app.name)) {
-                            app.launch_count = config.launch_counts[app.name];
-                        }
-                        if (config.last_launches.count(app.name)) {
-                            app.last_launch = config.last_launches[app.name];
-                        }
-                        if (config.favorites.count(app.name)) {
-                            app.is_favorite = true;
-                        }
-                        
-                        all_apps.push_back(app);
-                    }
-                }
-            }
+    // XDG_DATA_HOME first, so ~/.local shadows the system directories
+    static std::vector<std::string> application_dirs() {
+        std::vector<std::string> dirs = {std::string(g_get_user_data_dir()) + "/applications"};
+        for (const gchar * const *dir = g_get_system_data_dirs(); *dir; dir++) {
+            dirs.push_back(std::string(*dir) + "/applications");
         }
-
-        std::sort(all_apps.begin(), all_apps.end(), 
-            [](const DesktopApp& a, const DesktopApp& b) {
-                if (a.is_favorite != b.is_favorite) return a.is_favorite;
-                if (a.launch_count != b.launch_count) return a.launch_count > b.launch_count;
-                return a.name < b.name;
-            });
-        
-        filtered_apps = all_apps;
+        return dirs;
     }
-
-    DesktopApp parse_desktop_file(const std::string& filepath) {
-        DesktopApp app;
-        std::ifstream file(filepath);
-        std::string line;
-        bool in_desktop_entry = false;
-
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            
-            if (line == "[Desktop Entry]") {
-                in_desktop_entry = true;
-                continue;
-            } else if (line[0] == '[') {
-                in_desktop_entry = false;
-                continue;
+    
+    void load_applications() {
+        PROFILE_SCOPE_NAMED(scope, "load_applications", "apps");
+        std::vector<DesktopApp> apps = scan_desktop_files(application_dirs());
+        bool migrated_usage = false;
+        bool migrated_favorites = false;
+        
+        for (DesktopApp& app : apps) {
+            // Name-keyed history and favorites from older versions
+            if (usage.migrate(app.name, app.id)) {
+                migrated_usage = true;
             }
-
-            if (!in_desktop_entry) continue;
-
-            size_t eq_pos = line.find('=');
-            if (eq_pos == std::string::npos) continue;
-
-            std::string key = line.substr(0, eq_pos);
-            std::string value = line.substr(eq_pos + 1);
-
-            if (key == "Name") {
-                app.name = value;
-            } else if (key == "Exec") {
-                app.exec = value;
-            } else if (key == "Icon") {
-                app.icon = value;
-            } else if (key == "Comment") {
-                app.comment = value;
-            } else if (key == "Categories") {
-                app.categories = value;
-            } else if (key == "NoDisplay") {
-                app.no_display = (value == "true");
-            } else if (key == "Type" && value != "Application") {
-                app.no_display = true;
+            if (config.favorites.erase(app.name)) {
+                config.favorites.insert(app.id);
+                migrated_favorites = true;
             }
         }
-
-        return app;
-    }
-
-    void filter_apps(const std::string& search_text) {
-        filtered_apps.clear();
-        selected_index = 0;
-        calculator_mode = false;
-        web_search_mode = false;
-        command_mode = false;
-
-        if (search_text.empty()) {
-            filtered_apps = all_apps;
-            return;
-        }
         
-        if (search_text[0] == '?') {
-            web_search_mode = true;
-            return;
-        } else if (search_text[0] == '>') {
-            command_mode = true;
-            return;
+        if (migrated_usage) {
+            compact_usage();
         }
-        
-        std::regex math_regex(R"(^[\d\s\+\-\*\/\(\)\.]+$)");
-        if (std::regex_match(search_text, math_regex)) {
-            double result = calculate_expression(search_text);
-            if (!std::isnan(result)) {
-                calculator_mode = true;
-                return;
-            }
+        if (migrated_favorites) {
+            save_config();
         }
 
-        std::vector<std::pair<DesktopApp, int>> scored_apps;
+        build_catalog(apps, usage, config.favorites, catalog, app_index);
+        prefetched_slot = -1;
+        PROFILE_ARG(scope, static_cast<int64_t>(catalog.size()));
         
-        for (const auto& app : all_apps) {
-            int name_score = fuzzy_score(app.name, search_text);
-            int comment_score = fuzzy_score(app.comment, search_text) / 2;
-            int total_score = name_score + comment_score;
-            
-            if (total_score > 0) {
-                scored_apps.push_back({app, total_score});
-            }
+        filtered_apps.clear();
+        for (uint32_t slot = 0; slot < catalog.size(); slot++) {
+            filtered_apps.push_back(slot);
         }
+    }
+
+    void filter_apps(const std::string& search_text) {
+        PROFILE_SCOPE("filter_apps");
+        current_query = search_text;
+        selected_index = 0;
         
-        std::sort(scored_apps.begin(), scored_apps.end(),
-            [](const auto& a, const auto& b) {
-                return a.second > b.second;
-            });
+        gint64 search_start = g_get_monotonic_time();
+        QueryMode mode = dmenu ? filter_dmenu(search_text)
+                               : search(catalog, app_index, usage, search_text, filtered_apps);
+        metrics.search_us.add(g_get_monotonic_time() - search_start);
+        metrics.searches.add();
+        calculator_mode = mode == QUERY_CALCULATOR;
+        web_search_mode = mode == QUERY_WEB;
+        command_mode = mode == QUERY_COMMAND;
         
-        for (const auto& [app, score] : scored_apps) {
-            filtered_apps.push_back(app);
+        // The empty-query list is covered by prefetch_likely_apps()
+        if (!dmenu && config.prefetch_apps > 0 && !search_text.empty() && !filtered_apps.empty() &&
+            static_cast<int>(filtered_apps[0]) != prefetched_slot) {
+            prefetched_slot = filtered_apps[0];
+            prefetcher.request({std::string(catalog.command(filtered_apps[0]))});
         }
     }
 
-    std::string clean_exec(const std::string& exec) {
-        std::string cleaned = exec;
-        size_t pos;
-        while ((pos = cleaned.find('%')) != std::string::npos) {
-            if (pos + 1 < cleaned.length()) {
-                cleaned.erase(pos, 2);
-            } else {
-                cleaned.erase(pos, 1);
-            }
+    void launch_app(uint32_t slot) {
+        if (dmenu) {
+            finish_dmenu(dmenu_lines->line(slot));
+            return;
         }
-        return cleaned;
-    }
-
-    void launch_app(const DesktopApp& app) {
-        std::string cmd = clean_exec(app.exec);
-        GError *error = NULL;
-        
-        g_spawn_command_line_async(cmd.c_str(), &error);
-        
-        if (error) {
-            g_printerr("Failed to launch %s: %s\n", app.name.c_str(), error->message);
-            g_error_free(error);
-        } else {
-            for (auto& a : all_apps) {
-                if (a.name == app.name) {
-                    a.launch_count++;
-                    a.last_launch = time(NULL);
-                    config.launch_counts[a.name] = a.launch_count;
-                    config.last_launches[a.name] = a.last_launch;
-                    break;
-                }
+        prefetcher.note_launch(std::string(catalog.command(slot)));
+        if (spawner.spawn(catalog.argv(slot), catalog.name(slot))) {
+            metrics.launches.add();
+            std::string id(catalog.id(slot));
+            usage.record(id, current_query);
+            if (keystrokes) {
+                keystrokes->launch(g_get_monotonic_time(), id);
+            }
+            const UsageJournal::AppUsage *stats = usage.usage(id);
+            catalog.launch_count[slot] = stats->count;
+            catalog.last_launch[slot] = stats->last;
+            catalog.frecency[slot] = stats->frecency;
+            if (usage.needs_compaction()) {
+                compact_usage();
             }
-            config.save();
+            invalidate_grid();
         }
         
         toggle_visibility();
     }
     
-    void toggle_favorite(const DesktopApp& app) {
-        for (auto& a : all_apps) {
-            if (a.name == app.name) {
-                a.is_favorite = !a.is_favorite;
-                if (a.is_favorite) {
-                    config.favorites.insert(a.name);
-                } else {
-                    config.favorites.erase(a.name);
-                }
-                config.save();
-                break;
-            }
+    void toggle_favorite(uint32_t slot) {
+        if (dmenu) return;
+        std::string id(catalog.id(slot));
+        catalog.favorite[slot] = !catalog.favorite[slot];
+        if (catalog.favorite[slot]) {
+            config.favorites.insert(id);
+        } else {
+            config.favorites.erase(id);
         }
+        save_config();
         
         const char *text = gtk_editable_get_text(GTK_EDITABLE(search_entry));
         filter_apps(text);
         update_list();
+        invalidate_grid();
     }
     
     void execute_web_search(const std::string& query) {
-        std::string search_query = query.substr(1);
-        std::string url = "xdg-open 'https://www.google.com/search?q=" + search_query + "'";
-        int ret = system(url.c_str());
-        (void)ret;
+        char *escaped = g_uri_escape_string(query.substr(1).c_str(), NULL, FALSE);
+        std::string url = std::string("https://www.google.com/search?q=") + escaped;
+        g_free(escaped);
+        spawner.spawn({"xdg-open", url}, "xdg-open");
         toggle_visibility();
     }
     
+    // Plain commands are exec'd directly; only shell syntax pays for /bin/sh
     void execute_command(const std::string& command) {
         std::string cmd = command.substr(1);
-        cmd += " &";
-        int ret = system(cmd.c_str());
-        (void)ret;
+        std::vector<std::string> argv;
+        if (cmd.find_first_of("|&;<>()$`\\\"'*?[]{}~=\n") != std::string::npos) {
+            argv = {"/bin/sh", "-c", cmd};
+        } else {
+            std::istringstream words(cmd);
+            for (std::string word; words >> word;) {
+                argv.push_back(word);
+            }
+        }
+        if (!argv.empty()) {
+            spawner.spawn(argv, argv[0]);
+        }
         toggle_visibility();
     }
     
-    void show_power_menu() {
-        GtkWidget *dialog = gtk_dialog_new_with_buttons(
-            "Power Menu",
-            GTK_WINDOW(window),
-            GTK_DIALOG_MODAL,
-            "_Cancel", GTK_RESPONSE_CANCEL,
-            NULL
-        );
+    static constexpr gint64 PROCESS_BUDGET_US = 20000;
+    static constexpr gint64 KILL_CONFIRM_US = 3 * G_USEC_PER_SEC;
+    
+    void toggle_process_panel() {
+        process_panel_open = !process_panel_open;
+        gtk_widget_set_visible(process_panel, process_panel_open);
+        if (process_panel_open) {
+            // Rows from the last time the panel was open are stale
+            for (size_t i = 0; i < ProcessSampler::TOP; i++) {
+                gtk_widget_set_visible(process_labels[i], FALSE);
+                gtk_widget_set_visible(process_kill_buttons[i], FALSE);
+            }
+            process_sampler.start(governor.procfs_root, PROCESS_BUDGET_US);
+            process_timer = g_timeout_add_seconds(1, process_timer_callback, this);
+        } else {
+            process_sampler.pause();
+            if (process_timer != 0) {
+                g_source_remove(process_timer);
+                process_timer = 0;
+            }
+            kill_armed_pid = 0;
+        }
+    }
+    
+    static gboolean process_timer_callback(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->update_process_panel();
+        return G_SOURCE_CONTINUE;
+    }
+    
+    // Reuses the row widgets; only label text changes
+    void update_process_panel() {
+        ProcessSampler::Cost cost;
+        process_sampler.snapshot(process_rows, cost);
         
-        GtkWidget *content = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
+        if (kill_armed_pid != 0 && g_get_monotonic_time() - kill_armed_at > KILL_CONFIRM_US) {
+            kill_armed_pid = 0;
+        }
         
-        GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
-        gtk_widget_set_margin_start(box, 20);
-        gtk_widget_set_margin_end(box, 20);
-        gtk_widget_set_margin_top(box, 20);
-        gtk_widget_set_margin_bottom(box, 20);
+        char line[128];
+        for (size_t i = 0; i < ProcessSampler::TOP; i++) {
+            bool used = i < process_rows.size();
+            gtk_widget_set_visible(process_labels[i], used);
+            gtk_widget_set_visible(process_kill_buttons[i], used);
+            if (!used) continue;
+            
+            const ProcessSampler::Row& row = process_rows[i];
+            snprintf(line, sizeof(line), "%7d  %-16.16s %6.1f%% %8ld MB",
+                     row.pid, row.name.c_str(), row.cpu_percent, row.rss_kb / 1024);
+            gtk_label_set_text(GTK_LABEL(process_labels[i]), line);
+            gtk_button_set_label(GTK_BUTTON(process_kill_buttons[i]),
+                                 row.pid == kill_armed_pid ? "Kill?" : "✖");
+        }
         
-        GtkWidget *shutdown_btn = gtk_button_new_with_label("🔴 Shutdown");
-        GtkWidget *reboot_btn = gtk_button_new_with_label("🔄 Reboot");
-        GtkWidget *logout_btn = gtk_button_new_with_label("🚪 Logout");
+        if (debug_overlay) {
+            snprintf(line, sizeof(line), "sample %.1f/%.0f ms  %zu/%zu pids, %zu read  over budget %llu",
+                     cost.last_us / 1000.0, cost.budget_us / 1000.0, cost.refreshed, cost.pids,
+                     cost.reread, static_cast<unsigned long long>(cost.over_budget));
+            gtk_label_set_text(GTK_LABEL(process_cost_label), line);
+        }
+    }
+    
+    // The list reorders every second, so a kill needs two clicks on the same pid
+    static void on_kill_clicked(GtkButton *button, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        size_t index = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(button), "process_row"));
+        if (index >= launcher->process_rows.size()) return;
         
-        gtk_box_append(GTK_BOX(box), shutdown_btn);
-        gtk_box_append(GTK_BOX(box), reboot_btn);
-        gtk_box_append(GTK_BOX(box), logout_btn);
+        pid_t pid = launcher->process_rows[index].pid;
+        if (pid == getpid()) return;
         
-        #if GTK_IS_VERSION_4
-            gtk_box_append(GTK_BOX(content), box);
-        #else
-            gtk_container_add(GTK_CONTAINER(content), box);
-        #endif
+        gint64 now = g_get_monotonic_time();
+        if (pid == launcher->kill_armed_pid && now - launcher->kill_armed_at <= KILL_CONFIRM_US) {
+            if (kill(pid, SIGTERM) != 0) {
+                g_printerr("Failed to kill %d: %s\n", pid, g_strerror(errno));
+            }
+            launcher->kill_armed_pid = 0;
+        } else {
+            launcher->kill_armed_pid = pid;
+            launcher->kill_armed_at = now;
+        }
+        launcher->update_process_panel();
+    }
+    
+    static void on_process_sort_clicked(GtkButton *button, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->process_by_memory = !launcher->process_by_memory;
+        launcher->process_sampler.set_sort_by_memory(launcher->process_by_memory);
+        gtk_button_set_label(button, launcher->process_by_memory ? "Sort: RSS" : "Sort: CPU");
+    }
+    
+    void build_process_panel(GtkWidget *overlay) {
+        process_panel = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+        gtk_widget_set_name(process_panel, "process-panel");
+        gtk_widget_set_halign(process_panel, GTK_ALIGN_CENTER);
+        gtk_widget_set_valign(process_panel, GTK_ALIGN_CENTER);
         
-        g_signal_connect_swapped(shutdown_btn, "clicked", 
-            G_CALLBACK(+[](GtkDialog* d) { 
-                int ret = system("systemctl poweroff");
-                (void)ret;
-                #if GTK_IS_VERSION_4
-                    gtk_window_destroy(GTK_WINDOW(d));
-                #else
-                    gtk_widget_destroy(GTK_WIDGET(d));
-                #endif
-            }), dialog);
-            
-        g_signal_connect_swapped(reboot_btn, "clicked", 
-            G_CALLBACK(+[](GtkDialog* d) { 
-                int ret = system("systemctl reboot");
-                (void)ret;
-                #if GTK_IS_VERSION_4
-                    gtk_window_destroy(GTK_WINDOW(d));
-                #else
-                    gtk_widget_destroy(GTK_WIDGET(d));
-                #endif
-            }), dialog);
+        GtkWidget *title_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+        GtkWidget *title = gtk_label_new("    PID  NAME                CPU        RSS");
+        gtk_widget_set_name(title, "stats-label");
+        gtk_widget_set_hexpand(title, TRUE);
+        gtk_widget_set_halign(title, GTK_ALIGN_START);
+        gtk_box_append(GTK_BOX(title_box), title);
+        process_sort_button = gtk_button_new_with_label("Sort: CPU");
+        g_signal_connect(process_sort_button, "clicked", G_CALLBACK(on_process_sort_clicked), this);
+        gtk_box_append(GTK_BOX(title_box), process_sort_button);
+        gtk_box_append(GTK_BOX(process_panel), title_box);
+        
+        for (size_t i = 0; i < ProcessSampler::TOP; i++) {
+            GtkWidget *row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+            process_labels[i] = gtk_label_new("");
+            gtk_widget_set_name(process_labels[i], "stats-label");
+            gtk_widget_set_hexpand(process_labels[i], TRUE);
+            gtk_widget_set_halign(process_labels[i], GTK_ALIGN_START);
+            gtk_box_append(GTK_BOX(row), process_labels[i]);
             
-        g_signal_connect_swapped(logout_btn, "clicked", 
-            G_CALLBACK(+[](GtkDialog* d) { 
-                int ret = system("loginctl terminate-user $USER");
-                (void)ret;
-                #if GTK_IS_VERSION_4
-                    gtk_window_destroy(GTK_WINDOW(d));
-                #else
-                    gtk_widget_destroy(GTK_WIDGET(d));
-                #endif
-            }), dialog);
+            process_kill_buttons[i] = gtk_button_new_with_label("✖");
+            gtk_widget_set_can_focus(process_kill_buttons[i], FALSE);
+            g_object_set_data(G_OBJECT(process_kill_buttons[i]), "process_row", GINT_TO_POINTER(i));
+            g_signal_connect(process_kill_buttons[i], "clicked", G_CALLBACK(on_kill_clicked), this);
+            gtk_box_append(GTK_BOX(row), process_kill_buttons[i]);
+            gtk_box_append(GTK_BOX(process_panel), row);
+        }
+        
+        // Sampling cost against PROCESS_BUDGET_US, with the debug overlay only
+        process_cost_label = gtk_label_new("");
+        gtk_widget_set_name(process_cost_label, "stats-label");
+        gtk_widget_set_visible(process_cost_label, debug_overlay);
+        gtk_box_append(GTK_BOX(process_panel), process_cost_label);
         
+        gtk_widget_set_visible(process_panel, FALSE);
         #if GTK_IS_VERSION_3
-            gtk_widget_show_all(dialog);
-        #else
-            gtk_widget_show(dialog);
+            gtk_widget_show_all(process_panel);
+            gtk_widget_set_visible(process_cost_label, debug_overlay);
+            gtk_widget_hide(process_panel);
+            gtk_widget_set_no_show_all(process_panel, TRUE);
         #endif
+        gtk_overlay_add_overlay_compat(GTK_OVERLAY(overlay), process_panel);
+    }
+    
+    // In-window power menu: a panel on the overlay, driven by on_key_press.
+    // Nothing blocks, so rendering and the stats timer keep running.
+    static constexpr int POWER_ACTIONS = 3;
+    static constexpr int POWER_CONFIRM_SECONDS = 5;
+    
+    static const char* power_action_label(int action) {
+        static const char* labels[POWER_ACTIONS] = {"🔴 Shutdown", "🔄 Reboot", "🚪 Logout"};
+        return labels[action];
+    }
+    
+    static std::vector<std::string> power_action_argv(int action) {
+        switch (action) {
+            case 0: return {"systemctl", "poweroff"};
+            case 1: return {"systemctl", "reboot"};
+            default: return {"loginctl", "terminate-user", g_get_user_name()};
+        }
+    }
+    
+    void show_power_menu() {
+        if (power_menu_open) {
+            close_power_menu();
+            return;
+        }
+        power_menu_open = true;
+        power_selected = 0;
+        disarm_power_action();
         
-        gtk_dialog_run(GTK_DIALOG(dialog));
+        // Keys go to the window controller while the entry is insensitive
+        gtk_widget_set_sensitive(search_entry, FALSE);
+        gtk_widget_set_visible(power_panel, TRUE);
+        update_power_menu();
+    }
+    
+    void close_power_menu() {
+        if (!power_menu_open) return;
+        power_menu_open = false;
+        disarm_power_action();
+        gtk_widget_set_visible(power_panel, FALSE);
+        gtk_widget_set_sensitive(search_entry, TRUE);
+        gtk_widget_grab_focus(search_entry);
+    }
+    
+    void update_power_menu() {
+        for (int i = 0; i < POWER_ACTIONS; i++) {
+            GtkStyleContext *context = gtk_widget_get_style_context(power_buttons[i]);
+            if (i == power_selected) {
+                gtk_style_context_add_class(context, "selected-icon");
+            } else {
+                gtk_style_context_remove_class(context, "selected-icon");
+            }
+        }
         
-        #if GTK_IS_VERSION_4
-            gtk_window_destroy(GTK_WINDOW(dialog));
-        #else
-            gtk_widget_destroy(dialog);
+        if (power_armed >= 0) {
+            std::string hint = std::string("Press Enter again to confirm ") + power_action_label(power_armed) +
+                               " (" + std::to_string(power_confirm_left) + "s)";
+            gtk_label_set_text(GTK_LABEL(power_hint), hint.c_str());
+        } else {
+            gtk_label_set_text(GTK_LABEL(power_hint), "↑/↓ select · Enter confirm · Esc cancel");
+        }
+    }
+    
+    void disarm_power_action() {
+        power_armed = -1;
+        if (power_confirm_timer != 0) {
+            g_source_remove(power_confirm_timer);
+            power_confirm_timer = 0;
+        }
+    }
+    
+    // First activation arms the action, a second one within the timeout runs it
+    void activate_power_action(int action) {
+        if (power_armed == action) {
+            run_power_action(action);
+            return;
+        }
+        disarm_power_action();
+        power_selected = action;
+        power_armed = action;
+        power_confirm_left = POWER_CONFIRM_SECONDS;
+        power_confirm_timer = g_timeout_add_seconds(1, power_confirm_tick, this);
+        update_power_menu();
+    }
+    
+    static gboolean power_confirm_tick(gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        if (--launcher->power_confirm_left > 0) {
+            launcher->update_power_menu();
+            return G_SOURCE_CONTINUE;
+        }
+        launcher->power_confirm_timer = 0;
+        launcher->power_armed = -1;
+        launcher->update_power_menu();
+        return G_SOURCE_REMOVE;
+    }
+    
+    void run_power_action(int action) {
+        close_power_menu();
+        spawner.spawn(power_action_argv(action), power_action_label(action));
+        if (is_visible) {
+            toggle_visibility();
+        }
+    }
+    
+    gboolean handle_power_key(guint keyval) {
+        switch (keyval) {
+            case GDK_KEY_Escape:
+            case GDK_KEY_F12:
+                close_power_menu();
+                break;
+            case GDK_KEY_Up:
+            case GDK_KEY_Left:
+                power_selected = (power_selected + POWER_ACTIONS - 1) % POWER_ACTIONS;
+                disarm_power_action();
+                update_power_menu();
+                break;
+            case GDK_KEY_Down:
+            case GDK_KEY_Right:
+                power_selected = (power_selected + 1) % POWER_ACTIONS;
+                disarm_power_action();
+                update_power_menu();
+                break;
+            case GDK_KEY_Return:
+            case GDK_KEY_KP_Enter:
+                activate_power_action(power_selected);
+                break;
+        }
+        return TRUE;
+    }
+    
+    static void on_power_button_clicked(GtkButton *button, gpointer user_data) {
+        FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
+        launcher->activate_power_action(GPOINTER_TO_INT(g_object_get_data(G_OBJECT(button), "power_action")));
+    }
+    
+    void build_power_panel(GtkWidget *overlay) {
+        power_panel = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+        gtk_widget_set_name(power_panel, "power-panel");
+        gtk_widget_set_halign(power_panel, GTK_ALIGN_CENTER);
+        gtk_widget_set_valign(power_panel, GTK_ALIGN_CENTER);
+        
+        GtkWidget *title = gtk_label_new("Power");
+        gtk_widget_set_name(title, "stats-label");
+        gtk_box_append(GTK_BOX(power_panel), title);
+        
+        for (int i = 0; i < POWER_ACTIONS; i++) {
+            power_buttons[i] = gtk_button_new_with_label(power_action_label(i));
+            gtk_widget_set_can_focus(power_buttons[i], FALSE);
+            g_object_set_data(G_OBJECT(power_buttons[i]), "power_action", GINT_TO_POINTER(i));
+            g_signal_connect(power_buttons[i], "clicked", G_CALLBACK(on_power_button_clicked), this);
+            gtk_box_append(GTK_BOX(power_panel), power_buttons[i]);
+        }
+        
+        power_hint = gtk_label_new("");
+        gtk_widget_set_name(power_hint, "stats-label");
+        gtk_box_append(GTK_BOX(power_panel), power_hint);
+        
+        gtk_widget_set_visible(power_panel, FALSE);
+        #if GTK_IS_VERSION_3
+            gtk_widget_show_all(power_panel);
+            gtk_widget_hide(power_panel);
+            gtk_widget_set_no_show_all(power_panel, TRUE);
         #endif
+        gtk_overlay_add_overlay_compat(GTK_OVERLAY(overlay), power_panel);
     }
 
     #if GTK_IS_VERSION_4
@@ -1283,8 +3554,18 @@ public:
     static void on_search_changed(GtkSearchEntry *entry, gpointer user_data) {
         FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
         const char *text = gtk_editable_get_text(GTK_EDITABLE(entry));
+        
+        // search-changed is delayed; the grid may already show this query
+        if (launcher->current_query == text) return;
+        
+        if (launcher->keystrokes) {
+            launcher->keystrokes->query(g_get_monotonic_time(), text);
+        }
         launcher->filter_apps(text);
+        launcher->key_trace.mark(KEY_FILTERED);
         launcher->update_list();
+        launcher->key_trace.mark(KEY_LISTED);
+        launcher->grid_prewarmed = false;
     }
 
     #if GTK_IS_VERSION_4
@@ -1298,10 +3579,20 @@ public:
         FuturisticLauncher *launcher = static_cast<FuturisticLauncher*>(user_data);
         const int ICONS_PER_ROW = 3;
         
+        if (launcher->power_menu_open) {
+            return launcher->handle_power_key(keyval);
+        }
+        
+        if (launcher->process_panel_open && keyval == GDK_KEY_Escape) {
+            launcher->toggle_process_panel();
+            return TRUE;
+        }
+        
         if (state & GDK_CONTROL_MASK) {
             if (keyval >= GDK_KEY_1 && keyval <= GDK_KEY_7) {
                 launcher->config.current_theme = static_cast<Theme>(keyval - GDK_KEY_1);
                 launcher->apply_theme();
+                launcher->save_config();
                 return TRUE;
             }
         }
@@ -1317,7 +3608,11 @@ public:
         }
         
         if (keyval == GDK_KEY_Escape) {
-            launcher->toggle_visibility();
+            if (launcher->dmenu) {
+                launcher->quit();
+            } else {
+                launcher->toggle_visibility();
+            }
             return TRUE;
         } else if (keyval == GDK_KEY_Down) {
             if (launcher->selected_index + ICONS_PER_ROW < (int)launcher->filtered_apps.size()) {
@@ -1358,6 +3653,9 @@ public:
             } else if (!launcher->filtered_apps.empty() && 
                        launcher->selected_index < (int)launcher->filtered_apps.size()) {
                 launcher->launch_app(launcher->filtered_apps[launcher->selected_index]);
+            } else if (launcher->dmenu && !search_text.empty()) {
+                // Like dmenu, Enter with no match returns the typed text
+                launcher->finish_dmenu(search_text);
             }
             return TRUE;
         } else if (keyval == GDK_KEY_F12) {
@@ -1422,6 +3720,8 @@ public:
     }
 
     void update_list() {
+        PROFILE_SCOPE("update_list");
+        metrics.list_rebuilds.add();
         icon_widgets.clear();
         
         #if GTK_IS_VERSION_4
@@ -1527,7 +3827,11 @@ public:
             gtk_widget_set_margin_bottom(row_box, 5);
             
             for (int j = 0; j < ICONS_PER_ROW && (i + j) < filtered_apps.size(); j++) {
-                const auto& app = filtered_apps[i + j];
+                uint32_t slot = filtered_apps[i + j];
+                bool is_favorite = !dmenu && catalog.favorite[slot];
+                bool is_recent = !dmenu && (time(NULL) - catalog.last_launch[slot]) < 3600;
+                std::string_view icon = dmenu ? std::string_view("text-x-generic") : catalog.icon(slot);
+                std::string item = dmenu ? valid_utf8(dmenu_lines->line(slot)) : std::string(catalog.name(slot));
                 
                 GtkWidget *icon_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
                 gtk_widget_set_size_request(icon_box, 140, 110);
@@ -1535,18 +3839,18 @@ public:
                 
                 icon_widgets.push_back(icon_box);
                 
-                if (app.is_favorite || (time(NULL) - app.last_launch) < 3600) {
+                if (is_favorite || is_recent) {
                     GtkWidget *badge_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
                     gtk_widget_set_halign(badge_box, GTK_ALIGN_CENTER);
                     
-                    if (app.is_favorite) {
+                    if (is_favorite) {
                         GtkWidget *star = gtk_label_new("⭐");
                         GtkStyleContext *star_ctx = gtk_widget_get_style_context(star);
                         gtk_style_context_add_class(star_ctx, "favorite-star");
                         gtk_box_append(GTK_BOX(badge_box), star);
                     }
                     
-                    if ((time(NULL) - app.last_launch) < 3600) {
+                    if (is_recent) {
                         GtkWidget *recent = gtk_label_new("🕐");
                         GtkStyleContext *recent_ctx = gtk_widget_get_style_context(recent);
                         gtk_style_context_add_class(recent_ctx, "recent-badge");
@@ -1556,43 +3860,17 @@ public:
                     gtk_box_append(GTK_BOX(icon_box), badge_box);
                 }
                 
-                GtkWidget *icon_widget;
-                GtkIconTheme *icon_theme = gtk_icon_theme_get_default();
-                
-                if (!app.icon.empty()) {
-                    #if GTK_IS_VERSION_4
-                        GtkIconPaintable *icon_paintable = gtk_icon_theme_lookup_icon(
-                            icon_theme, app.icon.c_str(), NULL, config.icon_size, 1,
-                            GTK_TEXT_DIR_NONE, GTK_ICON_LOOKUP_FORCE_REGULAR);
-                        if (icon_paintable) {
-                            icon_widget = gtk_image_new_from_paintable(GDK_PAINTABLE(icon_paintable));
-                        } else {
-                            icon_widget = gtk_image_new_from_icon_name("application-x-executable");
-                        }
-                    #else
-                        GdkPixbuf *pixbuf = gtk_icon_theme_load_icon(icon_theme, app.icon.c_str(), 
-                                                                      config.icon_size, GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
-                        if (pixbuf) {
-                            icon_widget = gtk_image_new_from_pixbuf(pixbuf);
-                            g_object_unref(pixbuf);
-                        } else {
-                            icon_widget = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
-                        }
-                    #endif
-                } else {
-                    #if GTK_IS_VERSION_4
-                        icon_widget = gtk_image_new_from_icon_name("application-x-executable");
-                    #else
-                        icon_widget = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
-                    #endif
-                }
-                
+                GtkWidget *icon_widget = new_icon_image(icon);
                 gtk_widget_set_size_request(icon_widget, config.icon_size, config.icon_size);
                 gtk_box_append(GTK_BOX(icon_box), icon_widget);
                 
-                GtkWidget *label = gtk_label_new(app.name.c_str());
+                GtkWidget *label = gtk_label_new(item.c_str());
                 gtk_label_set_max_width_chars(GTK_LABEL(label), 18);
-                gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+                // Paths differ at the end, so dmenu items keep both ends
+                gtk_label_set_ellipsize(GTK_LABEL(label), dmenu ? PANGO_ELLIPSIZE_MIDDLE : PANGO_ELLIPSIZE_END);
+                if (dmenu) {
+                    gtk_widget_set_tooltip_text(icon_box, item.c_str());
+                }
                 gtk_label_set_justify(GTK_LABEL(label), GTK_JUSTIFY_CENTER);
                 gtk_widget_set_halign(label, GTK_ALIGN_CENTER);
                 
@@ -1635,6 +3913,7 @@ public:
                 gtk_widget_show_all(row_box);
             #endif
         }
+        metrics.list_tiles.add(icon_widgets.size());
 
         if (!filtered_apps.empty()) {
             selected_index = 0;
@@ -1674,20 +3953,6 @@ public:
         #endif
 
         // CSS
-        css_provider = gtk_css_provider_new();
-        #if GTK_IS_VERSION_4
-            gtk_style_context_add_provider_for_display(
-                gdk_display_get_default(),
-                GTK_STYLE_PROVIDER(css_provider),
-                GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-            );
-        #else
-            gtk_style_context_add_provider_for_screen(
-                gdk_screen_get_default(),
-                GTK_STYLE_PROVIDER(css_provider),
-                GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-            );
-        #endif
         apply_theme();
 
         // Create overlay to stack shader background and UI
@@ -1704,8 +3969,9 @@ public:
         gtk_widget_set_vexpand(gl_area, TRUE);
         gtk_gl_area_set_has_alpha(GTK_GL_AREA(gl_area), TRUE);
         g_signal_connect(gl_area, "realize", G_CALLBACK(on_gl_realize), this);
+        g_signal_connect(gl_area, "unrealize", G_CALLBACK(on_gl_unrealize), this);
         g_signal_connect(gl_area, "render", G_CALLBACK(on_gl_render), this);
-        gtk_widget_add_tick_callback(gl_area, gl_tick_callback, NULL, NULL);
+        gtk_widget_add_tick_callback(gl_area, gl_tick_callback, this, NULL);
         
         gtk_overlay_set_child(GTK_OVERLAY(overlay), gl_area);
         
@@ -1726,6 +3992,23 @@ public:
         gtk_widget_set_halign(stats_label, GTK_ALIGN_START);
         gtk_box_append(GTK_BOX(header_box), stats_label);
         
+        // Frame timing overlay, enabled with debug_overlay=1 or FUTURISTIC_LAUNCHER_DEBUG=1
+        const char *debug_env = g_getenv("FUTURISTIC_LAUNCHER_DEBUG");
+        debug_overlay = config.debug_overlay || (debug_env && debug_env[0] == '1');
+        debug_label = gtk_label_new("");
+        gtk_widget_set_name(debug_label, "stats-label");
+        gtk_widget_set_halign(debug_label, GTK_ALIGN_END);
+        gtk_widget_set_visible(debug_label, debug_overlay);
+        #if GTK_IS_VERSION_3
+            gtk_widget_set_no_show_all(debug_label, TRUE);
+        #endif
+        gtk_box_append(GTK_BOX(header_box), debug_label);
+        
+        process_button = gtk_button_new_with_label("📊");
+        g_signal_connect_swapped(process_button, "clicked", 
+            G_CALLBACK(+[](FuturisticLauncher* l) { l->toggle_process_panel(); }), this);
+        gtk_box_append(GTK_BOX(header_box), process_button);
+        
         power_menu_button = gtk_button_new_with_label("⚡");
         g_signal_connect_swapped(power_menu_button, "clicked", 
             G_CALLBACK(+[](FuturisticLauncher* l) { l->show_power_menu(); }), this);
@@ -1762,6 +4045,10 @@ public:
         gtk_list_box_set_activate_on_single_click(GTK_LIST_BOX(app_list), FALSE);
         gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrolled_window), app_list);
 
+        // Panels above the main UI
+        build_power_panel(overlay);
+        build_process_panel(overlay);
+
         // Key press
         #if GTK_IS_VERSION_4
             GtkEventController *key_controller = gtk_event_controller_key_new();
@@ -1771,44 +4058,114 @@ public:
             g_signal_connect(window, "key-press-event", G_CALLBACK(on_key_press), this);
         #endif
 
-        update_list();
+        prewarm_grid();
         
-        stats_timer = g_timeout_add_seconds(1, stats_timer_callback, this);
+        sampler.open_files(governor.procfs_root);
         update_stats();
+        
+        // First decision skips the hysteresis hold
+        governor.sample();
+        governor.mode = governor.candidate = governor.target(config);
+        apply_auto_render();
 
+        if (!dmenu && config.metrics_interval_s > 0) {
+            write_metrics_file();
+            metrics_timer = g_timeout_add_seconds(config.metrics_interval_s, metrics_timer_callback, this);
+        }
+        
         gtk_window_present_compat(GTK_WINDOW(window));
         gtk_widget_grab_focus(search_entry);
     }
 };
 
-FuturisticLauncher* FuturisticLauncher::g_launcher_instance = nullptr;
-
+// futuristic-launcher-daemon; the futuristic-launcher client (client.cpp) execs
+// it with the same arguments when no daemon answered, but it also runs directly
 int main(int argc, char *argv[]) {
-    #if GTK_IS_VERSION_4
-        gtk_init();
-    #else
-        gtk_init(&argc, &argv);
-    #endif
+    gint64 client_start = g_get_monotonic_time();
+    if (const char *stamp = getenv("FUTURISTIC_LAUNCHER_CLIENT_START")) {
+        client_start = g_ascii_strtoll(stamp, NULL, 10);
+        unsetenv("FUTURISTIC_LAUNCHER_CLIENT_START");  // not for launched apps
+    }
+    
+    ControlOptions options = parse_control_options(argc, argv);
+    if (options.exit_status >= 0) {
+        return options.exit_status;
+    }
+    if (options.ping_count > 0) {
+        return control_measure_latency(options.ping_count);
+    }
+    const std::string& request = options.request;
+    std::string profile_path = options.profile_path;
+    if (options.profile && profile_path.empty()) {
+        profile_path = std::string(g_get_user_runtime_dir()) + "/futuristic-launcher-profile.json";
+    }
     
-    FuturisticLauncher launcher;
+    // Standalone: no control socket or lock, so it runs beside a daemon
+    if (options.dmenu) {
+        #if GTK_IS_VERSION_4
+            gtk_init();
+        #else
+            gtk_init(&argc, &argv);
+        #endif
+        
+        FuturisticLauncher launcher(-1, true);
+        launcher.install_signal_handlers();
+        launcher.run();
+        launcher.start_dmenu();
+        launcher.handle_control_command("show");
+        launcher.run_main_loop();
+        return launcher.dmenu_exit_status();
+    }
     
-    if (!launcher.try_acquire_lock()) {
-        FuturisticLauncher::signal_toggle();
-        return 0;
+    // Hand the request to a running daemon before paying for GTK and the app catalog
+    int status = control_forward(options, client_start);
+    if (status >= 0) {
+        return status;
     }
     
-    FuturisticLauncher::g_launcher_instance = &launcher;
-    signal(SIGUSR1, FuturisticLauncher::handle_signal);
-    launcher.save_pid();
+    std::string reply;
+    int lock_fd = control_acquire_lock();
+    if (lock_fd < 0 && !profile_path.empty()) {
+        std::cerr << "futuristic-launcher: a daemon is already running; quit it before profiling" << std::endl;
+        return 1;
+    }
+    if (lock_fd < 0) {
+        // Another daemon is starting up; wait briefly for its socket
+        for (int i = 0; i < 50; i++) {
+            usleep(20000);
+            if (control_send(request, reply)) return 0;
+        }
+        std::cerr << "futuristic-launcher: daemon is not answering" << std::endl;
+        return 1;
+    }
     
-    launcher.run();
-    launcher.toggle_visibility();
+    #if FUTURISTIC_LAUNCHER_PROFILE
+        if (!profile_path.empty()) Profiler::instance().enable();
+    #endif
     
     #if GTK_IS_VERSION_4
-        GMainLoop *loop = g_main_loop_new(NULL, FALSE);
-        g_main_loop_run(loop);
+        gtk_init();
     #else
-        gtk_main();
+        gtk_init(&argc, &argv);
+    #endif
+    
+    {
+        FuturisticLauncher launcher(lock_fd);
+        
+        launcher.install_signal_handlers();
+        launcher.start_control_server();
+        
+        launcher.run();
+        launcher.handle_control_command(request + control_trace_suffix(client_start));
+        launcher.run_main_loop();
+    }
+    
+    // The destructor joined the worker threads, so every ring is quiescent
+    #if FUTURISTIC_LAUNCHER_PROFILE
+        if (!profile_path.empty() && !Profiler::instance().write(profile_path)) {
+            std::cerr << "futuristic-launcher: failed to write " << profile_path << std::endl;
+            return 1;
+        }
     #endif
     
     return 0;
@@ -72,7 +72,8 @@ fi
 
 # Install
 echo -e "${BLUE}[3/4]${NC} Installing to /usr/local/bin..."
-if sudo cp futuristic-launcher /usr/local/bin/ && sudo chmod +x /usr/local/bin/futuristic-launcher; then
+if sudo cp futuristic-launcher futuristic-launcher-daemon /usr/local/bin/ &&
+   sudo chmod +x /usr/local/bin/futuristic-launcher /usr/local/bin/futuristic-launcher-daemon; then
     echo -e "${GREEN}✓ Installation successful${NC}"
 else
     echo -e "${RED}✗ Installation failed${NC}"